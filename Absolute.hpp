@@ -3,6 +3,7 @@
 #include "Dimension.hpp"
 #include "Quantity.hpp"
 
+#include <concepts>
 #include <utility>
 
 namespace rgf
@@ -57,10 +58,21 @@ namespace rgf
          mStandardValue = aValue;
       }
 
-      template<unit_type<absolute> UNIT>
+      //! Units that accept an absolute, such as affine_unit, convert it with their own zero.
+      //! Other units of the same dimension, such as linear_unit, measure the absolute from the standard zero,
+      //!    e.g. kelvins for temperatures or meters for positions.
+      template<typename UNIT>
+         requires unit_type<UNIT, absolute> || unit_type<UNIT, quantity_type>
       constexpr auto get(const UNIT& aUnit) const
       {
-         return aUnit.from_standard_value(*this);
+         if constexpr (unit_type<UNIT, absolute>)
+         {
+            return aUnit.get(*this);
+         }
+         else
+         {
+            return aUnit.get(quantity_type(std::in_place, mStandardValue));
+         }
       }
 
       //! In-place addition operators.
@@ -104,7 +116,7 @@ namespace rgf
       }
       template<arithmetic T>
       constexpr friend absolute<dimension, sum_t<T, value_type>>
-         operator+(const quantity_type<dimension, T>& aLeft, const absolute& aRight) noexcept requires is_scalar
+         operator+(const quantity<dimension, T>& aLeft, const absolute& aRight) noexcept requires is_scalar
       {
          return { std::in_place, aLeft + aRight.get_standard() };
       }
@@ -132,7 +144,19 @@ namespace rgf
       }
 
       //! Comparison operators.
-      constexpr friend auto operator==(const absolute& aLeft, const absolute& aRight) noexcept = default;
+      //! Value types whose equality does not return bool, e.g. SIMD vectors, compare element-wise and return a mask.
+      constexpr friend bool operator==(const absolute& aLeft, const absolute& aRight) noexcept
+         requires std::equality_comparable<value_type> = default;
+      constexpr friend auto operator==(const absolute& aLeft, const absolute& aRight) noexcept
+         requires (!std::equality_comparable<value_type>)
+      {
+         return aLeft.get_standard() == aRight.get_standard();
+      }
+      constexpr friend auto operator!=(const absolute& aLeft, const absolute& aRight) noexcept
+         requires (!std::equality_comparable<value_type>)
+      {
+         return aLeft.get_standard() != aRight.get_standard();
+      }
 
    private:
       value_type mStandardValue = value_type();
@@ -151,4 +175,8 @@ namespace rgf
    {
       return { std::in_place, aAbsolute.get_standard() };
    }
+
+   static_assert(rgf::detail::is_zero_overhead_wrapper_v<absolute<dimension_t<>, float>>);
+   static_assert(rgf::detail::is_zero_overhead_wrapper_v<absolute<dimension_t<>, double>>);
+   static_assert(rgf::detail::is_zero_overhead_wrapper_v<absolute<dimension_t<>, long long>>);
 }
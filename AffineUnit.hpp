@@ -0,0 +1,251 @@
+#pragma once
+
+#include "Absolute.hpp"
+#include "Conversion.hpp"
+#include "Quantity.hpp"
+
+#include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace rgf
+{
+   namespace detail
+   {
+      //! Returns aValue * aScale + aOffset.
+      //! Where the target has a fused multiply-add instruction, the result is rounded once, and loops over it vectorize to it.
+      //! Otherwise the multiplication and addition are rounded separately, since a software fma is an order of magnitude slower.
+      template<std::floating_point T>
+      constexpr T multiply_add(T aValue, T aScale, T aOffset) noexcept
+      {
+#if defined(FP_FAST_FMA)
+         if (!std::is_constant_evaluated())
+         {
+            return std::fma(aValue, aScale, aOffset);
+         }
+#endif
+         return aValue * aScale + aOffset;
+      }
+
+      //! Writes aValues[i] * aScale + aOffset to aResults[i] for every i.
+      //! aValues and aResults may be the same buffer.
+      template<std::floating_point T>
+      constexpr void affine_values(const T* aValues, T* aResults, std::size_t aSize, T aScale, T aOffset) noexcept
+      {
+         for (std::size_t i = 0; i < aSize; ++i)
+         {
+            aResults[i] = rgf::detail::multiply_add(aValues[i], aScale, aOffset);
+         }
+      }
+   }
+
+   //! affine_unit is a unit whose zero differs from the standard zero, such as Celsius and Fahrenheit, or a time scale with its own epoch.
+   //! A value v in the unit is v * scale() + offset() in standard units, so offset() is the unit's zero in standard units.
+   //! Absolutes are converted with the offset, while quantities are differences and are converted by the scale only,
+   //!    e.g. absolute 0C is 273.15K, but a difference of 1C is 1K.
+   //! Every conversion is a single multiply-add. Converting back uses the reciprocal of the scale, which may differ from a
+   //!    true division by one unit in the last place.
+   //! Only floating point value types are supported, since offsets such as 273.15 are rarely integral.
+   template<rgf::dimension_type UNIT_DIMENSION, std::floating_point UNIT_VALUE_TYPE = double>
+   class affine_unit
+   {
+   public:
+      using dimension = UNIT_DIMENSION;
+      using value_type = UNIT_VALUE_TYPE;
+
+      using quantity_type = quantity<dimension, value_type>;
+      using absolute_type = absolute<dimension, value_type>;
+
+      //! When default-constructed, the unit is the standard unit.
+      constexpr explicit affine_unit() noexcept = default;
+
+      constexpr affine_unit(std::in_place_t, value_type aScale, value_type aOffset) noexcept
+         : mScale(aScale)
+         , mOffset(aOffset)
+      {}
+
+      //! Linear units convert to affine units that share the standard zero, e.g. kelvins or rankines.
+      template<multiplicative_unit UNIT>
+         requires std::same_as<typename UNIT::dimension, dimension> && std::same_as<typename UNIT::value_type, value_type>
+      constexpr affine_unit(const UNIT& aUnit) noexcept
+         : mScale(aUnit.conversion_factor())
+      {}
+
+      //! Returns the size of one unit in standard units.
+      constexpr value_type scale() const noexcept
+      {
+         return mScale;
+      }
+      //! Returns the unit's zero in standard units.
+      constexpr value_type offset() const noexcept
+      {
+         return mOffset;
+      }
+
+      //! The call operator converts a value to an absolute with that value.
+      //! E.g. celsius(100) is an absolute temperature of 373.15 kelvins.
+      constexpr absolute_type operator()(value_type aValue) const noexcept
+      {
+         return { std::in_place, to_standard_value(aValue) };
+      }
+      constexpr value_type to_standard_value(value_type aValue) const noexcept
+      {
+         return rgf::detail::multiply_add(aValue, mScale, mOffset);
+      }
+      //! Converts from standard units into *this's unit.
+      constexpr value_type from_standard_value(value_type aValue) const noexcept
+      {
+         const value_type inverse = 1 / mScale;
+         return rgf::detail::multiply_add(aValue, inverse, -mOffset * inverse);
+      }
+      //! Converts an absolute from standard units into *this's unit.
+      constexpr value_type get(absolute_type aAbsolute) const noexcept
+      {
+         return from_standard_value(aAbsolute.get_standard());
+      }
+      //! Converts a quantity, which is a difference, into *this's unit. The offset does not apply.
+      constexpr value_type get(quantity_type aQuantity) const noexcept
+      {
+         return aQuantity.get_standard() / mScale;
+      }
+
+      //! Batch versions of to_standard_value.
+      //! Overload 1 converts aValues in place.
+      //! Overload 2 writes the converted values to aResults, which must be at least as large as aValues.
+      constexpr void to_standard_values(std::span<value_type> aValues) const noexcept
+      {
+         rgf::detail::affine_values(aValues.data(), aValues.data(), aValues.size(), mScale, mOffset);
+      }
+      constexpr void to_standard_values(std::span<const value_type> aValues, std::span<value_type> aResults) const noexcept
+      {
+         assert(aResults.size() >= aValues.size());
+         rgf::detail::affine_values(aValues.data(), aResults.data(), aValues.size(), mScale, mOffset);
+      }
+
+      //! Batch versions of from_standard_value.
+      //! Overload 1 converts aValues in place.
+      //! Overload 2 writes the converted values to aResults, which must be at least as large as aValues.
+      constexpr void from_standard_values(std::span<value_type> aValues) const noexcept
+      {
+         const value_type inverse = 1 / mScale;
+         rgf::detail::affine_values(aValues.data(), aValues.data(), aValues.size(), inverse, -mOffset * inverse);
+      }
+      constexpr void from_standard_values(std::span<const value_type> aValues, std::span<value_type> aResults) const noexcept
+      {
+         assert(aResults.size() >= aValues.size());
+         const value_type inverse = 1 / mScale;
+         rgf::detail::affine_values(aValues.data(), aResults.data(), aValues.size(), inverse, -mOffset * inverse);
+      }
+
+      //! Creates a new affine_unit scaled up in size, with the same zero.
+      //! E.g. a hypothetical kilocelsius = celsius.scaled_up(1000) would still have its zero at 273.15K.
+      constexpr affine_unit scaled_up(value_type aFactor) const noexcept
+      {
+         return affine_unit(std::in_place, mScale * aFactor, mOffset);
+      }
+      //! Creates a new affine_unit scaled down in size, with the same zero.
+      constexpr affine_unit scaled_down(value_type aFactor) const noexcept
+      {
+         return affine_unit(std::in_place, mScale / aFactor, mOffset);
+      }
+      //! Creates a new affine_unit of the same size, whose zero is at aOrigin in *this's unit.
+      //! Origins compose, e.g. inline constexpr auto celsius = rgf::affine_unit(kelvins).with_origin(273.15);
+      constexpr affine_unit with_origin(value_type aOrigin) const noexcept
+      {
+         return affine_unit(std::in_place, mScale, to_standard_value(aOrigin));
+      }
+
+   private:
+      value_type mScale = 1;
+      value_type mOffset = 0;
+   };
+
+   template<multiplicative_unit UNIT>
+   affine_unit(const UNIT&) -> affine_unit<typename UNIT::dimension, typename UNIT::value_type>;
+
+   //! affine_conversion converts absolute values expressed in one unit directly into another unit, e.g. Celsius to Fahrenheit.
+   //! The two units' scales and offsets are fused when the conversion is constructed,
+   //!    so each conversion is a single multiply-add rather than a trip through standard units.
+   template<rgf::dimension_type DIMENSION, std::floating_point VALUE_TYPE = double>
+   class affine_conversion
+   {
+   public:
+      using dimension = DIMENSION;
+      using value_type = VALUE_TYPE;
+      using unit_type = affine_unit<dimension, value_type>;
+
+      constexpr affine_conversion(const unit_type& aFrom, const unit_type& aTo) noexcept
+         : mScale(aFrom.scale() / aTo.scale())
+         , mOffset((aFrom.offset() - aTo.offset()) / aTo.scale())
+      {}
+
+      //! Returns the fused scale.
+      constexpr value_type scale() const noexcept
+      {
+         return mScale;
+      }
+      //! Returns the fused offset, which is the source unit's zero expressed in the target unit.
+      constexpr value_type offset() const noexcept
+      {
+         return mOffset;
+      }
+
+      //! Converts a single value from the source unit into the target unit.
+      constexpr value_type operator()(value_type aValue) const noexcept
+      {
+         return rgf::detail::multiply_add(aValue, mScale, mOffset);
+      }
+
+      //! Batch versions of operator().
+      //! Overload 1 converts aValues in place.
+      //! Overload 2 writes the converted values to aResults, which must be at least as large as aValues.
+      constexpr void convert_values(std::span<value_type> aValues) const noexcept
+      {
+         rgf::detail::affine_values(aValues.data(), aValues.data(), aValues.size(), mScale, mOffset);
+      }
+      constexpr void convert_values(std::span<const value_type> aValues, std::span<value_type> aResults) const noexcept
+      {
+         assert(aResults.size() >= aValues.size());
+         rgf::detail::affine_values(aValues.data(), aResults.data(), aValues.size(), mScale, mOffset);
+      }
+
+   private:
+      value_type mScale;
+      value_type mOffset;
+   };
+
+   template<rgf::dimension_type DIMENSION, std::floating_point VALUE_TYPE>
+   affine_conversion(const affine_unit<DIMENSION, VALUE_TYPE>&, const affine_unit<DIMENSION, VALUE_TYPE>&)
+      -> affine_conversion<DIMENSION, VALUE_TYPE>;
+
+   //! Converts aValue from aFrom's unit into aTo's unit with a single fused multiply-add.
+   //! E.g. rgf::convert(451.0, fahrenheit, celsius);
+   template<rgf::dimension_type DIMENSION, std::floating_point VALUE_TYPE>
+   constexpr VALUE_TYPE convert(VALUE_TYPE aValue, const affine_unit<DIMENSION, VALUE_TYPE>& aFrom,
+      const affine_unit<DIMENSION, VALUE_TYPE>& aTo) noexcept
+   {
+      return affine_conversion(aFrom, aTo)(aValue);
+   }
+
+   //! Batch versions of convert.
+   //! Overload 1 converts aValues in place.
+   //! Overload 2 writes the converted values to aResults, which must be at least as large as aValues.
+   template<rgf::dimension_type DIMENSION, std::floating_point VALUE_TYPE>
+   constexpr void convert(std::span<VALUE_TYPE> aValues, const affine_unit<DIMENSION, VALUE_TYPE>& aFrom,
+      const affine_unit<DIMENSION, VALUE_TYPE>& aTo) noexcept
+   {
+      affine_conversion(aFrom, aTo).convert_values(aValues);
+   }
+   template<rgf::dimension_type DIMENSION, std::floating_point VALUE_TYPE>
+   constexpr void convert(std::span<const VALUE_TYPE> aValues, std::span<VALUE_TYPE> aResults,
+      const affine_unit<DIMENSION, VALUE_TYPE>& aFrom, const affine_unit<DIMENSION, VALUE_TYPE>& aTo) noexcept
+   {
+      affine_conversion(aFrom, aTo).convert_values(aValues, aResults);
+   }
+
+   static_assert(sizeof(affine_unit<dimension_t<>, double>) == 2 * sizeof(double));
+}
@@ -0,0 +1,133 @@
+#pragma once
+
+#include "Dimension.hpp"
+#include "Quantity.hpp"
+
+#include <atomic>
+#include <cstdint>
+
+namespace rgf
+{
+   //! atomic_quantity<DIMENSION, VALUE_TYPE> is a quantity that may be read and modified by several threads at once,
+   //!    with the interface of std::atomic, e.g. a count of bytes transferred or of busy time shared between workers.
+   //! Only quantities of the same dimension may be added or subtracted, as with quantity::operator+=.
+   //! Every operation takes an optional std::memory_order. Counters that are only read once the workers are done can use
+   //!    std::memory_order_relaxed, which on x86-64 makes integral fetch_add a single locked instruction.
+   //! Floating point fetch_add and fetch_sub are compare-exchange loops, which are lock-free but slow down under contention.
+   //!    Heavily contended counters should accumulate locally and publish the total, or use one counter per thread.
+   template<dimension_type DIMENSION, arithmetic VALUE_TYPE = double>
+   class atomic_quantity
+   {
+   public:
+      using dimension = DIMENSION;
+      using value_type = VALUE_TYPE;
+
+      using quantity_type = quantity<dimension, value_type>;
+
+      constexpr static bool is_always_lock_free = std::atomic<value_type>::is_always_lock_free;
+
+      //! When default-constructed, the standard value is value-initialized, as with quantity.
+      constexpr atomic_quantity() noexcept = default;
+      constexpr atomic_quantity(const quantity_type& aQuantity) noexcept
+         : mStandardValue(aQuantity.get_standard())
+      {}
+
+      atomic_quantity(const atomic_quantity&) = delete;
+      atomic_quantity& operator=(const atomic_quantity&) = delete;
+
+      quantity_type operator=(const quantity_type& aQuantity) noexcept
+      {
+         store(aQuantity);
+         return aQuantity;
+      }
+      operator quantity_type() const noexcept
+      {
+         return load();
+      }
+
+      bool is_lock_free() const noexcept
+      {
+         return mStandardValue.is_lock_free();
+      }
+
+      quantity_type load(std::memory_order aOrder = std::memory_order_seq_cst) const noexcept
+      {
+         return { std::in_place, mStandardValue.load(aOrder) };
+      }
+      void store(const quantity_type& aQuantity, std::memory_order aOrder = std::memory_order_seq_cst) noexcept
+      {
+         mStandardValue.store(aQuantity.get_standard(), aOrder);
+      }
+      //! Replaces the quantity with aQuantity and returns the previous quantity.
+      quantity_type exchange(const quantity_type& aQuantity, std::memory_order aOrder = std::memory_order_seq_cst) noexcept
+      {
+         return { std::in_place, mStandardValue.exchange(aQuantity.get_standard(), aOrder) };
+      }
+
+      //! Replaces the quantity with aDesired if it equals aExpected, and returns true.
+      //! Otherwise, aExpected is updated to the current quantity and false is returned.
+      //! The weak version may fail spuriously, and is preferred inside loops.
+      //! Floating point values are compared by their representation, so e.g. 0.0 and -0.0 differ.
+      bool compare_exchange_weak(quantity_type& aExpected, const quantity_type& aDesired,
+         std::memory_order aSuccess, std::memory_order aFailure) noexcept
+      {
+         value_type expected = aExpected.get_standard();
+         const bool exchanged = mStandardValue.compare_exchange_weak(expected, aDesired.get_standard(), aSuccess, aFailure);
+         aExpected.set_standard_value(expected);
+         return exchanged;
+      }
+      bool compare_exchange_weak(quantity_type& aExpected, const quantity_type& aDesired,
+         std::memory_order aOrder = std::memory_order_seq_cst) noexcept
+      {
+         value_type expected = aExpected.get_standard();
+         const bool exchanged = mStandardValue.compare_exchange_weak(expected, aDesired.get_standard(), aOrder);
+         aExpected.set_standard_value(expected);
+         return exchanged;
+      }
+      bool compare_exchange_strong(quantity_type& aExpected, const quantity_type& aDesired,
+         std::memory_order aSuccess, std::memory_order aFailure) noexcept
+      {
+         value_type expected = aExpected.get_standard();
+         const bool exchanged = mStandardValue.compare_exchange_strong(expected, aDesired.get_standard(), aSuccess, aFailure);
+         aExpected.set_standard_value(expected);
+         return exchanged;
+      }
+      bool compare_exchange_strong(quantity_type& aExpected, const quantity_type& aDesired,
+         std::memory_order aOrder = std::memory_order_seq_cst) noexcept
+      {
+         value_type expected = aExpected.get_standard();
+         const bool exchanged = mStandardValue.compare_exchange_strong(expected, aDesired.get_standard(), aOrder);
+         aExpected.set_standard_value(expected);
+         return exchanged;
+      }
+
+      //! Adds or subtracts aQuantity and returns the previous quantity.
+      quantity_type fetch_add(const quantity_type& aQuantity, std::memory_order aOrder = std::memory_order_seq_cst) noexcept
+      {
+         return { std::in_place, mStandardValue.fetch_add(aQuantity.get_standard(), aOrder) };
+      }
+      quantity_type fetch_sub(const quantity_type& aQuantity, std::memory_order aOrder = std::memory_order_seq_cst) noexcept
+      {
+         return { std::in_place, mStandardValue.fetch_sub(aQuantity.get_standard(), aOrder) };
+      }
+
+      //! In-place addition and subtraction operators.
+      //! As with std::atomic, these return the new quantity rather than a reference.
+      quantity_type operator+=(const quantity_type& aQuantity) noexcept
+      {
+         return quantity_type(fetch_add(aQuantity) + aQuantity);
+      }
+      quantity_type operator-=(const quantity_type& aQuantity) noexcept
+      {
+         return quantity_type(fetch_sub(aQuantity) - aQuantity);
+      }
+
+   private:
+      std::atomic<value_type> mStandardValue{};
+   };
+
+#if defined(__x86_64__) || defined(_M_X64)
+   static_assert(atomic_quantity<dimension_t<>, double>::is_always_lock_free);
+   static_assert(atomic_quantity<dimension_t<>, std::int64_t>::is_always_lock_free);
+#endif
+}
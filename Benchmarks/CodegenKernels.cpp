@@ -0,0 +1,177 @@
+// Kernels for check_codegen.sh, which compiles this file twice and fails if the two builds disassemble differently.
+// With RGF_CODEGEN_WRAPPED=1 the kernels use quantity, linear_unit and absolute; with RGF_CODEGEN_WRAPPED=0 they use the
+//    bare value types and the arithmetic the library is documented to perform. Each kernel is written once, against the
+//    aliases and helpers below, so the only difference between the builds is the types.
+// Kernels are extern "C" so both builds emit the same symbol names, and the wrappers are passed and returned in the same
+//    registers as their value types.
+
+#include "../Absolute.hpp"
+#include "../CommonUnits.hpp"
+
+#include <cstddef>
+#include <cstdint>
+
+#ifndef RGF_CODEGEN_WRAPPED
+#error "Define RGF_CODEGEN_WRAPPED as 0 or 1."
+#endif
+
+namespace codegen
+{
+#if RGF_CODEGEN_WRAPPED
+   using length = rgf::length_quantity;
+   using length_f = rgf::length_quantity_t<float>;
+   using duration = rgf::time_quantity;
+   using speed = rgf::velocity_quantity;
+   using mass = rgf::mass_quantity;
+   using force = rgf::force_quantity;
+   using energy = rgf::energy_quantity;
+   using byte_count = rgf::data_quantity_t<std::int64_t>;
+   using position = rgf::absolute<rgf::length_dimension>;
+
+   inline length kilometers(double aValue)
+   {
+      return rgf::kilometers(aValue);
+   }
+   inline double in_kilometers(length aLength)
+   {
+      return aLength.get(rgf::kilometers);
+   }
+#else
+   using length = double;
+   using length_f = float;
+   using duration = double;
+   using speed = double;
+   using mass = double;
+   using force = double;
+   using energy = double;
+   using byte_count = std::int64_t;
+   using position = double;
+
+   inline length kilometers(double aValue)
+   {
+      return aValue * 1000.0;
+   }
+   inline double in_kilometers(length aLength)
+   {
+      return aLength / 1000.0;
+   }
+#endif
+}
+
+using namespace codegen;
+
+extern "C"
+{
+   void codegen_add(const length* aLeft, const length* aRight, length* aOut, std::size_t aSize)
+   {
+      for (std::size_t i = 0; i < aSize; ++i)
+      {
+         aOut[i] = aLeft[i] + aRight[i];
+      }
+   }
+
+   void codegen_add_float(const length_f* aLeft, const length_f* aRight, length_f* aOut, std::size_t aSize)
+   {
+      for (std::size_t i = 0; i < aSize; ++i)
+      {
+         aOut[i] = aLeft[i] + aRight[i];
+      }
+   }
+
+   void codegen_add_int64(const byte_count* aLeft, const byte_count* aRight, byte_count* aOut, std::size_t aSize)
+   {
+      for (std::size_t i = 0; i < aSize; ++i)
+      {
+         aOut[i] = aLeft[i] + aRight[i];
+      }
+   }
+
+   void codegen_scale(const length* aValues, double aFactor, length* aOut, std::size_t aSize)
+   {
+      for (std::size_t i = 0; i < aSize; ++i)
+      {
+         aOut[i] = aValues[i] * aFactor;
+      }
+   }
+
+   void codegen_speed(const length* aDistances, const duration* aTimes, speed* aOut, std::size_t aSize)
+   {
+      for (std::size_t i = 0; i < aSize; ++i)
+      {
+         aOut[i] = aDistances[i] / aTimes[i];
+      }
+   }
+
+   void codegen_kinetic_energy(const mass* aMasses, const speed* aSpeeds, energy* aOut, std::size_t aSize)
+   {
+      for (std::size_t i = 0; i < aSize; ++i)
+      {
+         aOut[i] = 0.5 * aMasses[i] * aSpeeds[i] * aSpeeds[i];
+      }
+   }
+
+   void codegen_to_kilometers(const double* aValues, length* aOut, std::size_t aSize)
+   {
+      for (std::size_t i = 0; i < aSize; ++i)
+      {
+         aOut[i] = kilometers(aValues[i]);
+      }
+   }
+
+   void codegen_in_kilometers(const length* aLengths, double* aOut, std::size_t aSize)
+   {
+      for (std::size_t i = 0; i < aSize; ++i)
+      {
+         aOut[i] = in_kilometers(aLengths[i]);
+      }
+   }
+
+   void codegen_displacement(const position* aFrom, const position* aTo, length* aOut, std::size_t aSize)
+   {
+      for (std::size_t i = 0; i < aSize; ++i)
+      {
+         aOut[i] = aTo[i] - aFrom[i];
+      }
+   }
+
+   void codegen_translate(const position* aPositions, length aOffset, position* aOut, std::size_t aSize)
+   {
+      for (std::size_t i = 0; i < aSize; ++i)
+      {
+         aOut[i] = aPositions[i] + aOffset;
+      }
+   }
+
+   energy codegen_work(const force* aForces, const length* aDistances, std::size_t aSize)
+   {
+      // The index is declared before the sum, as the wrapped build orders them once the sum is split into its value.
+      //    Otherwise the two builds schedule the zeroing of the sum differently, which is not a cost of the wrapper.
+      std::size_t i = 0;
+      energy result{};
+      for (; i < aSize; ++i)
+      {
+         result += aForces[i] * aDistances[i];
+      }
+      return result;
+   }
+
+   std::size_t codegen_count_below(const length* aLengths, length aLimit, std::size_t aSize)
+   {
+      std::size_t result = 0;
+      for (std::size_t i = 0; i < aSize; ++i)
+      {
+         result += aLengths[i] < aLimit;
+      }
+      return result;
+   }
+
+   double codegen_ratio(length aLeft, length aRight)
+   {
+      return aLeft / aRight;
+   }
+
+   length codegen_midpoint(length aLeft, length aRight)
+   {
+      return (aLeft + aRight) / 2.0;
+   }
+}
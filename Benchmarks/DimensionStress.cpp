@@ -0,0 +1,74 @@
+//! Stress translation unit for comparing the dimension_t and packed_dimension_t representations.
+//! It instantiates quantity products, quotients and squares for RGF_STRESS_COUNT distinct dimensions
+//!    and takes the address of each, so that every instantiation is emitted with its mangled name and debug info.
+//! Compare compile time, object size and debug info size of the two builds, e.g.
+//!    time g++ -std=c++20 -g -c -I.. DimensionStress.cpp -o unpacked.o
+//!    time g++ -std=c++20 -g -c -I.. -DRGF_STRESS_PACKED DimensionStress.cpp -o packed.o
+//!    size -A unpacked.o packed.o
+
+#include "../CommonDimensions.hpp"
+#include "../PackedDimension.hpp"
+#include "../Quantity.hpp"
+
+#include <array>
+#include <cstddef>
+#include <utility>
+
+#ifndef RGF_STRESS_COUNT
+#define RGF_STRESS_COUNT 200
+#endif
+
+namespace
+{
+   //! Exponent of base aBase in the aIndex'th dimension: the base-7 digits of aIndex, shifted into [-3, 3].
+   //! Every index below 7^7 therefore maps to a distinct dimension.
+   constexpr int exponent(int aIndex, int aBase)
+   {
+      for (int i = 0; i < aBase; ++i)
+      {
+         aIndex /= 7;
+      }
+      return aIndex % 7 - 3;
+   }
+
+#if defined(RGF_STRESS_PACKED)
+   template<int I>
+   using stress_dimension = rgf::packed_dimension_t<rgf::standard_system, rgf::pack_exponents(
+      exponent(I, 0), exponent(I, 1), exponent(I, 2), exponent(I, 3), exponent(I, 4), exponent(I, 5), exponent(I, 6))>;
+#else
+   template<int I>
+   using stress_dimension = rgf::dimension_t<rgf::length<exponent(I, 0)>, rgf::time<exponent(I, 1)>, rgf::mass<exponent(I, 2)>,
+      rgf::angle<exponent(I, 3)>, rgf::data<exponent(I, 4)>, rgf::charge<exponent(I, 5)>, rgf::temperature<exponent(I, 6)>>;
+#endif
+
+   template<int I>
+   using stress_quantity = rgf::quantity<stress_dimension<I>>;
+
+   template<int I>
+   auto product(stress_quantity<I> aLeft, stress_quantity<I + 1> aRight)
+   {
+      return aLeft * aRight;
+   }
+   template<int I>
+   auto quotient(stress_quantity<I> aLeft, stress_quantity<I + 1> aRight)
+   {
+      return aLeft / aRight;
+   }
+   template<int I>
+   auto square(stress_quantity<I> aValue)
+   {
+      return rgf::quantity<rgf::dimension_exponent_t<stress_dimension<I>, 2>>(std::in_place, aValue.get_standard() * aValue.get_standard());
+   }
+
+   template<std::size_t... INDICES>
+   constexpr auto make_table(std::index_sequence<INDICES...>)
+   {
+      return std::array<const void*, 3 * sizeof...(INDICES)>{
+         reinterpret_cast<const void*>(&product<INDICES>)...,
+         reinterpret_cast<const void*>(&quotient<INDICES>)...,
+         reinterpret_cast<const void*>(&square<INDICES>)... };
+   }
+}
+
+extern const std::array<const void*, 3 * RGF_STRESS_COUNT> gStressTable;
+const std::array<const void*, 3 * RGF_STRESS_COUNT> gStressTable = make_table(std::make_index_sequence<RGF_STRESS_COUNT>());
@@ -0,0 +1,506 @@
+//! Zero-overhead benchmark for rgf::quantity, rgf::linear_unit, rgf::affine_unit and rgf::absolute, and the overhead of
+//!    rgf::dynamic_quantity and of rgf::parse_quantity, rgf::to_chars, rgf::sum and rgf::log_unit.
+//! Every kernel is run twice over the same data: once through the library types and once as hand-written loops
+//!    over the raw value type. If the library is zero-cost, the two timings should match at -O2 and above.
+//! Results are written to stdout as JSON.
+//!
+//! The benchmark is self-contained and has no dependencies outside the standard library. Build it directly, e.g.
+//!    g++ -std=c++20 -O2 -DRGF_BENCHMARK_OPTIMIZATION=\"O2\" -I.. QuantityBenchmark.cpp -o QuantityBenchmark
+//! or use run_benchmarks.sh, which builds and runs it at -O0, -O2 and -O3.
+
+#include "../Absolute.hpp"
+#include "../CommonUnits.hpp"
+#include "../DynamicQuantity.hpp"
+#include "../QuantityExpression.hpp"
+#include "../QuantityFormat.hpp"
+#include "../Reduce.hpp"
+#include "../UnitParser.hpp"
+
+#include <algorithm>
+#include <charconv>
+#include <cmath>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <numeric>
+#include <random>
+#include <span>
+#include <string>
+#include <string_view>
+#include <type_traits>
+#include <vector>
+
+#ifndef RGF_BENCHMARK_OPTIMIZATION
+#define RGF_BENCHMARK_OPTIMIZATION "unknown"
+#endif
+
+namespace
+{
+   constexpr std::size_t sElementCount = 1 << 14;
+   constexpr int sRepetitions = 200;
+
+   //! Prevents the compiler from discarding a computed value, or from assuming memory has not changed.
+   template<typename T>
+   void do_not_optimize(T& aValue)
+   {
+#if defined(__GNUC__)
+      asm volatile("" : : "r,m"(aValue) : "memory");
+#else
+      static volatile T* volatile sink;
+      sink = &aValue;
+#endif
+   }
+
+   //! Runs aKernel sRepetitions times and returns the fastest run in nanoseconds per element.
+   template<typename KERNEL>
+   double time_kernel(KERNEL aKernel)
+   {
+      double best = 1e300;
+      for (int repetition = 0; repetition < sRepetitions; ++repetition)
+      {
+         const auto start = std::chrono::steady_clock::now();
+         aKernel();
+         const auto stop = std::chrono::steady_clock::now();
+         best = std::min(best, std::chrono::duration<double, std::nano>(stop - start).count());
+      }
+      return best / sElementCount;
+   }
+
+   //! Returns sElementCount values in [1, 100), so that division and unit conversions stay well defined for every type.
+   template<typename T>
+   std::vector<T> make_values(unsigned aSeed)
+   {
+      std::mt19937 generator(aSeed);
+      std::uniform_real_distribution<double> distribution(1, 100);
+      std::vector<T> values(sElementCount);
+      for (T& value : values)
+      {
+         value = static_cast<T>(distribution(generator));
+      }
+      return values;
+   }
+
+   template<typename QUANTITY, typename T>
+   std::vector<QUANTITY> to_quantities(const std::vector<T>& aValues)
+   {
+      std::vector<QUANTITY> quantities;
+      quantities.reserve(aValues.size());
+      for (T value : aValues)
+      {
+         quantities.emplace_back(std::in_place, value);
+      }
+      return quantities;
+   }
+
+   class json_writer
+   {
+   public:
+      json_writer()
+      {
+         std::printf("{\n");
+         std::printf("  \"compiler\": \"%s\",\n", compiler());
+         std::printf("  \"optimization\": \"%s\",\n", RGF_BENCHMARK_OPTIMIZATION);
+         std::printf("  \"element_count\": %zu,\n", sElementCount);
+         std::printf("  \"repetitions\": %d,\n", sRepetitions);
+         std::printf("  \"results\": [");
+      }
+      ~json_writer()
+      {
+         std::printf("\n  ]\n}\n");
+      }
+
+      void write(std::string_view aName, std::string_view aType, double aQuantityNs, double aRawNs)
+      {
+         std::printf("%s\n    {\"benchmark\": \"%.*s\", \"value_type\": \"%.*s\", "
+            "\"quantity_ns_per_element\": %.4f, \"raw_ns_per_element\": %.4f, \"ratio\": %.3f}",
+            mFirst ? "" : ",", static_cast<int>(aName.size()), aName.data(), static_cast<int>(aType.size()), aType.data(),
+            aQuantityNs, aRawNs, aRawNs > 0 ? aQuantityNs / aRawNs : 0.0);
+         mFirst = false;
+      }
+
+   private:
+      static const char* compiler()
+      {
+#if defined(__clang__)
+         return "clang " __clang_version__;
+#elif defined(__GNUC__)
+         return "gcc " __VERSION__;
+#elif defined(_MSC_VER)
+         return "msvc";
+#else
+         return "unknown";
+#endif
+      }
+
+      bool mFirst = true;
+   };
+
+   //! Times an element-wise binary kernel over quantities against the same kernel over raw values.
+   template<typename LQ, typename RQ, typename T, typename QUANTITY_OPERATION, typename RAW_OPERATION>
+   void benchmark_binary(json_writer& aWriter, std::string_view aName, std::string_view aType,
+      QUANTITY_OPERATION aQuantityOperation, RAW_OPERATION aRawOperation)
+   {
+      const std::vector<T> left = make_values<T>(1);
+      const std::vector<T> right = make_values<T>(2);
+      const std::vector<LQ> leftQuantities = to_quantities<LQ>(left);
+      const std::vector<RQ> rightQuantities = to_quantities<RQ>(right);
+
+      using result_quantity = decltype(aQuantityOperation(leftQuantities[0], rightQuantities[0]));
+      using raw_result = decltype(aRawOperation(left[0], right[0]));
+      std::vector<result_quantity> quantityResults(sElementCount);
+      std::vector<raw_result> rawResults(sElementCount);
+
+      const double quantityNs = time_kernel([&]
+      {
+         for (std::size_t i = 0; i < sElementCount; ++i)
+         {
+            quantityResults[i] = aQuantityOperation(leftQuantities[i], rightQuantities[i]);
+         }
+         do_not_optimize(quantityResults);
+      });
+      const double rawNs = time_kernel([&]
+      {
+         for (std::size_t i = 0; i < sElementCount; ++i)
+         {
+            rawResults[i] = aRawOperation(left[i], right[i]);
+         }
+         do_not_optimize(rawResults);
+      });
+      aWriter.write(aName, aType, quantityNs, rawNs);
+   }
+
+   //! Times an element-wise unary kernel over quantities against the same kernel over raw values.
+   template<typename Q, typename T, typename QUANTITY_OPERATION, typename RAW_OPERATION>
+   void benchmark_unary(json_writer& aWriter, std::string_view aName, std::string_view aType,
+      QUANTITY_OPERATION aQuantityOperation, RAW_OPERATION aRawOperation)
+   {
+      const std::vector<T> values = make_values<T>(3);
+      const std::vector<Q> quantities = to_quantities<Q>(values);
+
+      using quantity_result = decltype(aQuantityOperation(quantities[0]));
+      using raw_result = decltype(aRawOperation(values[0]));
+      std::vector<quantity_result> quantityResults(sElementCount);
+      std::vector<raw_result> rawResults(sElementCount);
+
+      const double quantityNs = time_kernel([&]
+      {
+         for (std::size_t i = 0; i < sElementCount; ++i)
+         {
+            quantityResults[i] = aQuantityOperation(quantities[i]);
+         }
+         do_not_optimize(quantityResults);
+      });
+      const double rawNs = time_kernel([&]
+      {
+         for (std::size_t i = 0; i < sElementCount; ++i)
+         {
+            rawResults[i] = aRawOperation(values[i]);
+         }
+         do_not_optimize(rawResults);
+      });
+      aWriter.write(aName, aType, quantityNs, rawNs);
+   }
+
+   template<typename T>
+   void benchmark_value_type(json_writer& aWriter, std::string_view aType)
+   {
+      using length = rgf::length_quantity_t<T>;
+      using time = rgf::time_quantity_t<T>;
+      using unit = rgf::linear_length_unit_t<T>;
+      using absolute = rgf::absolute<rgf::temperature_dimension, T>;
+      using temperature = rgf::temperature_quantity_t<T>;
+
+      benchmark_binary<length, length, T>(aWriter, "quantity_add", aType,
+         [](length aL, length aR) { return aL + aR; }, [](T aL, T aR) { return aL + aR; });
+      benchmark_binary<length, length, T>(aWriter, "quantity_subtract", aType,
+         [](length aL, length aR) { return aL - aR; }, [](T aL, T aR) { return aL - aR; });
+      benchmark_binary<length, time, T>(aWriter, "quantity_multiply", aType,
+         [](length aL, time aR) { return aL * aR; }, [](T aL, T aR) { return aL * aR; });
+      benchmark_binary<length, time, T>(aWriter, "quantity_divide", aType,
+         [](length aL, time aR) { return aL / aR; }, [](T aL, T aR) { return aL / aR; });
+      benchmark_binary<length, length, T>(aWriter, "quantity_compare", aType,
+         [](length aL, length aR) { return aL < aR; }, [](T aL, T aR) { return aL < aR; });
+
+      // The unit is copied out of a volatile so that its factor is a runtime value in both kernels.
+      static volatile T sFactor = static_cast<T>(1000);
+      const unit kilo(std::in_place, static_cast<T>(sFactor));
+      const T factor = sFactor;
+      benchmark_unary<length, T>(aWriter, "linear_unit_to_standard", aType,
+         [kilo](length aL) { return kilo(aL.get_standard()); }, [factor](T aV) { return aV * factor; });
+      benchmark_unary<length, T>(aWriter, "linear_unit_from_standard", aType,
+         [kilo](length aL) { return aL.get(kilo); }, [factor](T aV) { return aV / factor; });
+
+      benchmark_binary<absolute, temperature, T>(aWriter, "absolute_add", aType,
+         [](absolute aL, temperature aR) { return aL + aR; }, [](T aL, T aR) { return aL + aR; });
+      benchmark_binary<absolute, absolute, T>(aWriter, "absolute_subtract", aType,
+         [](absolute aL, absolute aR) { return aL - aR; }, [](T aL, T aR) { return aL - aR; });
+
+      if constexpr (std::is_floating_point_v<T>)
+      {
+         static volatile T sOffset = static_cast<T>(273.15);
+         const rgf::affine_unit<rgf::temperature_dimension, T> celsius(std::in_place, 1, static_cast<T>(sOffset));
+         const T offset = sOffset;
+         benchmark_unary<absolute, T>(aWriter, "affine_unit_from_standard", aType,
+            [celsius](absolute aA) { return aA.get(celsius); }, [offset](T aV) { return aV - offset; });
+      }
+   }
+
+   //! Times a batch Celsius to Fahrenheit conversion against the equivalent hand-written loop.
+   void benchmark_affine_conversion(json_writer& aWriter)
+   {
+      const std::vector<double> values = make_values<double>(7);
+      std::vector<double> quantityResults(sElementCount);
+      std::vector<double> rawResults(sElementCount);
+      const double quantityNs = time_kernel([&]
+      {
+         rgf::convert(std::span<const double>(values), std::span<double>(quantityResults), rgf::celsius, rgf::fahrenheit);
+         do_not_optimize(quantityResults);
+      });
+      const double rawNs = time_kernel([&]
+      {
+         for (std::size_t i = 0; i < sElementCount; ++i)
+         {
+            rawResults[i] = values[i] * 1.8 + 32;
+         }
+         do_not_optimize(rawResults);
+      });
+      aWriter.write("affine_conversion", "double", quantityNs, rawNs);
+   }
+
+   //! Times an element-wise binary kernel over dynamic quantities against the same kernel over raw values.
+   //! Dimensions are read through a volatile, so the compiler cannot prove the dimension checks away.
+   template<typename LQ, typename RQ, typename DYNAMIC_OPERATION, typename RAW_OPERATION>
+   void benchmark_dynamic(json_writer& aWriter, std::string_view aName, DYNAMIC_OPERATION aDynamicOperation, RAW_OPERATION aRawOperation)
+   {
+      using dynamic = rgf::dynamic_quantity<rgf::standard_system>;
+      static volatile rgf::packed_exponents sLeftDimension = dynamic(LQ()).dimension().exponents();
+      static volatile rgf::packed_exponents sRightDimension = dynamic(RQ()).dimension().exponents();
+      const auto leftDimension = dynamic::runtime_dimension_type::from_exponents(sLeftDimension);
+      const auto rightDimension = dynamic::runtime_dimension_type::from_exponents(sRightDimension);
+
+      const std::vector<double> left = make_values<double>(1);
+      const std::vector<double> right = make_values<double>(2);
+      std::vector<dynamic> leftQuantities;
+      std::vector<dynamic> rightQuantities;
+      for (std::size_t i = 0; i < sElementCount; ++i)
+      {
+         leftQuantities.emplace_back(left[i], leftDimension);
+         rightQuantities.emplace_back(right[i], rightDimension);
+      }
+      std::vector<dynamic> dynamicResults(sElementCount);
+      std::vector<double> rawResults(sElementCount);
+
+      const double dynamicNs = time_kernel([&]
+      {
+         for (std::size_t i = 0; i < sElementCount; ++i)
+         {
+            dynamicResults[i] = aDynamicOperation(leftQuantities[i], rightQuantities[i]);
+         }
+         do_not_optimize(dynamicResults);
+      });
+      const double rawNs = time_kernel([&]
+      {
+         for (std::size_t i = 0; i < sElementCount; ++i)
+         {
+            rawResults[i] = aRawOperation(left[i], right[i]);
+         }
+         do_not_optimize(rawResults);
+      });
+      aWriter.write(aName, "double", dynamicNs, rawNs);
+   }
+
+   //! dynamic_quantity is not zero-overhead: it carries and checks a runtime dimension next to every value.
+   void benchmark_dynamic_quantity(json_writer& aWriter)
+   {
+      using dynamic = rgf::dynamic_quantity<rgf::standard_system>;
+      benchmark_dynamic<rgf::length_quantity, rgf::length_quantity>(aWriter, "dynamic_quantity_add",
+         [](const dynamic& aL, const dynamic& aR) { return aL + aR; }, [](double aL, double aR) { return aL + aR; });
+      benchmark_dynamic<rgf::length_quantity, rgf::time_quantity>(aWriter, "dynamic_quantity_divide",
+         [](const dynamic& aL, const dynamic& aR) { return aL / aR; }, [](double aL, double aR) { return aL / aR; });
+   }
+
+   //! Times parse_quantity on short strings such as "12.5 km/h" against std::from_chars parsing only their numbers.
+   void benchmark_unit_parser(json_writer& aWriter)
+   {
+      constexpr const char* units[] = { "m", "km/h", "s", "ms", "kg", "m/s^2", "N", "deg" };
+      const std::vector<double> values = make_values<double>(4);
+      std::string text;
+      std::vector<std::size_t> offsets;
+      for (std::size_t i = 0; i < sElementCount; ++i)
+      {
+         char buffer[32];
+         offsets.push_back(text.size());
+         text.append(buffer, std::snprintf(buffer, sizeof(buffer), "%.*f %s", static_cast<int>(i % 3), values[i], units[i % std::size(units)]));
+      }
+      offsets.push_back(text.size());
+
+      std::vector<rgf::dynamic_quantity<rgf::standard_system>> quantityResults(sElementCount);
+      std::vector<double> rawResults(sElementCount);
+      const double quantityNs = time_kernel([&]
+      {
+         for (std::size_t i = 0; i < sElementCount; ++i)
+         {
+            rgf::parse_quantity(text.data() + offsets[i], text.data() + offsets[i + 1], quantityResults[i]);
+         }
+         do_not_optimize(quantityResults);
+      });
+      const double rawNs = time_kernel([&]
+      {
+         for (std::size_t i = 0; i < sElementCount; ++i)
+         {
+            std::from_chars(text.data() + offsets[i], text.data() + offsets[i + 1], rawResults[i]);
+         }
+         do_not_optimize(rawResults);
+      });
+      aWriter.write("unit_parser", "double", quantityNs, rawNs);
+   }
+
+   //! Times rgf::to_chars with automatic SI prefixes against std::to_chars writing only the value.
+   void benchmark_formatting(json_writer& aWriter)
+   {
+      const std::vector<double> values = make_values<double>(5);
+      const std::vector<rgf::length_quantity> quantities = to_quantities<rgf::length_quantity>(values);
+      const rgf::quantity_format format("auto");
+      std::vector<char> quantityText(sElementCount * 32);
+      std::vector<char> rawText(sElementCount * 32);
+
+      const double quantityNs = time_kernel([&]
+      {
+         for (std::size_t i = 0; i < sElementCount; ++i)
+         {
+            char* first = quantityText.data() + i * 32;
+            rgf::to_chars(first, first + 32, quantities[i] * 1000, format);
+         }
+         do_not_optimize(quantityText);
+      });
+      const double rawNs = time_kernel([&]
+      {
+         for (std::size_t i = 0; i < sElementCount; ++i)
+         {
+            char* first = rawText.data() + i * 32;
+            std::to_chars(first, first + 32, values[i]);
+         }
+         do_not_optimize(rawText);
+      });
+      aWriter.write("quantity_to_chars", "double", quantityNs, rawNs);
+   }
+
+   //! Times rgf::sum against std::accumulate over the raw values.
+   //! The library's pairwise summation is expected to be faster, since std::accumulate adds in a single dependency chain.
+   void benchmark_reduce(json_writer& aWriter)
+   {
+      const std::vector<double> values = make_values<double>(6);
+      rgf::quantity_array<rgf::length_dimension> quantities(values.size());
+      std::copy(values.begin(), values.end(), quantities.data());
+
+      const auto benchmark_sum = [&](std::string_view aName, rgf::summation aSummation)
+      {
+         const double quantityNs = time_kernel([&]
+         {
+            rgf::length_quantity result = rgf::sum(quantities, aSummation);
+            do_not_optimize(result);
+         });
+         const double rawNs = time_kernel([&]
+         {
+            double result = std::accumulate(values.begin(), values.end(), 0.0);
+            do_not_optimize(result);
+         });
+         aWriter.write(aName, "double", quantityNs, rawNs);
+      };
+      benchmark_sum("reduce_sum_pairwise", rgf::summation::pairwise);
+      benchmark_sum("reduce_sum_neumaier", rgf::summation::neumaier);
+   }
+
+   //! Times kinetic energy over arrays, evaluated eagerly with temporaries and lazily in one fused loop,
+   //!    against the same fused loop over raw values.
+   void benchmark_expression(json_writer& aWriter)
+   {
+      const std::vector<double> masses = make_values<double>(9);
+      const std::vector<double> speeds = make_values<double>(10);
+      rgf::quantity_array<rgf::mass_dimension> m(masses.size());
+      rgf::quantity_array<rgf::velocity_dimension> v(speeds.size());
+      std::copy(masses.begin(), masses.end(), m.data());
+      std::copy(speeds.begin(), speeds.end(), v.data());
+      rgf::quantity_array<rgf::energy_dimension> energies(sElementCount);
+      std::vector<double> rawEnergies(sElementCount);
+
+      const double rawNs = time_kernel([&]
+      {
+         for (std::size_t i = 0; i < sElementCount; ++i)
+         {
+            rawEnergies[i] = 0.5 * masses[i] * speeds[i] * speeds[i];
+         }
+         do_not_optimize(rawEnergies);
+      });
+      const double eagerNs = time_kernel([&]
+      {
+         energies = 0.5 * m * v * v;
+         do_not_optimize(energies);
+      });
+      const double lazyNs = time_kernel([&]
+      {
+         energies = 0.5 * rgf::lazy(m) * v * v;
+         do_not_optimize(energies);
+      });
+      aWriter.write("expression_kinetic_energy_eager", "double", eagerNs, rawNs);
+      aWriter.write("expression_kinetic_energy_lazy", "double", lazyNs, rawNs);
+   }
+
+   //! Times batch conversions from power quantities to dBm against the std::log10 loop they replace.
+   void benchmark_log_unit(json_writer& aWriter)
+   {
+      const std::vector<double> values = make_values<double>(8);
+      std::vector<double> quantityResults(sElementCount);
+      std::vector<double> rawResults(sElementCount);
+      const auto benchmark_precision = [&](std::string_view aName, rgf::log_precision aPrecision)
+      {
+         const double quantityNs = time_kernel([&]
+         {
+            rgf::dBm.from_standard_values(std::span<const double>(values), std::span<double>(quantityResults), aPrecision);
+            do_not_optimize(quantityResults);
+         });
+         const double rawNs = time_kernel([&]
+         {
+            for (std::size_t i = 0; i < sElementCount; ++i)
+            {
+               rawResults[i] = 10 * std::log10(values[i] / 0.001);
+            }
+            do_not_optimize(rawResults);
+         });
+         aWriter.write(aName, "double", quantityNs, rawNs);
+      };
+      benchmark_precision("log_unit_from_standard_exact", rgf::log_precision::exact);
+      benchmark_precision("log_unit_from_standard_fast", rgf::log_precision::fast);
+   }
+
+   void benchmark_compound_unit(json_writer& aWriter)
+   {
+      // Compound units are built inside the loop, so the product of the factors is part of what is measured.
+      static volatile double sNewtonFactor = 1;
+      static volatile double sMeterFactor = 1;
+      const rgf::linear_force_unit newtons(std::in_place, sNewtonFactor);
+      const rgf::linear_length_unit meters(std::in_place, sMeterFactor);
+      const double newtonFactor = sNewtonFactor;
+      const double meterFactor = sMeterFactor;
+      benchmark_unary<rgf::energy_quantity, double>(aWriter, "compound_unit_get", "double",
+         [newtons, meters](rgf::energy_quantity aE) { return aE.get(newtons * meters); },
+         [newtonFactor, meterFactor](double aV) { return aV / (newtonFactor * meterFactor); });
+   }
+}
+
+int main()
+{
+   json_writer writer;
+   benchmark_value_type<float>(writer, "float");
+   benchmark_value_type<double>(writer, "double");
+   benchmark_value_type<std::int64_t>(writer, "int64_t");
+   benchmark_compound_unit(writer);
+   benchmark_dynamic_quantity(writer);
+   benchmark_unit_parser(writer);
+   benchmark_formatting(writer);
+   benchmark_reduce(writer);
+   benchmark_expression(writer);
+   benchmark_affine_conversion(writer);
+   benchmark_log_unit(writer);
+}
@@ -0,0 +1,59 @@
+//! Checks that rgf::rate_meter reads a steady input rate as that rate.
+//! Amounts are recorded at a constant rate between updates, on a simulated clock, and every rate is read after each
+//!    update. The program prints each mismatch and exits with status 1 if there is any. Build and run it directly, e.g.
+//!    g++ -std=c++20 -O2 -I.. RateMeterCheck.cpp -o RateMeterCheck && ./RateMeterCheck
+
+#include "../CommonUnits.hpp"
+#include "../RateMeter.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+
+namespace
+{
+   using clock = std::chrono::steady_clock;
+
+   //! Records aBytesPerSecond for aSeconds, updating the meter every aUpdatePeriod, and checks the windowed and mean
+   //!    rates after every update. Returns the number of mismatches.
+   int check_steady_rate(const char* aName, std::int64_t aBytesPerSecond, std::chrono::milliseconds aUpdatePeriod, int aSeconds)
+   {
+      const clock::time_point start{};
+      rgf::rate_meter<rgf::data_quantity_t<std::int64_t>> meter(rgf::seconds(10), 10, start);
+      const std::int64_t bytesPerUpdate = aBytesPerSecond * aUpdatePeriod.count() / 1000;
+      const double expected = static_cast<double>(aBytesPerSecond);
+
+      int failures = 0;
+      for (clock::time_point now = start + aUpdatePeriod; now <= start + std::chrono::seconds(aSeconds); now += aUpdatePeriod)
+      {
+         meter.record(rgf::data_quantity_t<std::int64_t>(std::in_place, bytesPerUpdate));
+         meter.update(now);
+         const double windowed = meter.windowed_rate(now).get(rgf::bytes / rgf::seconds);
+         const double mean = meter.mean_rate(now).get(rgf::bytes / rgf::seconds);
+         if (std::abs(windowed - expected) > expected * 1e-9 || std::abs(mean - expected) > expected * 1e-9)
+         {
+            std::printf("%s at %.3f s: windowed %.6g B/s, mean %.6g B/s, expected %.6g B/s\n", aName,
+               std::chrono::duration<double>(now - start).count(), windowed, mean, expected);
+            ++failures;
+         }
+      }
+      return failures;
+   }
+}
+
+int main()
+{
+   int failures = 0;
+   failures += check_steady_rate("one update per bucket", 1'000'000, std::chrono::milliseconds(1000), 30);
+   failures += check_steady_rate("four updates per bucket", 1'000'000, std::chrono::milliseconds(250), 30);
+   failures += check_steady_rate("one update per two buckets", 1'000'000, std::chrono::milliseconds(2000), 30);
+   failures += check_steady_rate("updates not aligned to buckets", 1'000'000, std::chrono::milliseconds(700), 30);
+   if (failures != 0)
+   {
+      std::printf("rate_meter: %d mismatches\n", failures);
+      return 1;
+   }
+   std::printf("rate_meter: steady rates read correctly\n");
+   return 0;
+}
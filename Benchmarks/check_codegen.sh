@@ -0,0 +1,49 @@
+#!/bin/sh
+# Checks that quantity, linear_unit and absolute compile to the same instructions as their bare value types.
+# Builds CodegenKernels.cpp with and without the wrappers at -O2 and -O3, disassembles both objects, and prints a diff
+#    and exits with status 1 if any kernel differs, e.g. because a change blocked vectorization, added a branch or a
+#    spill, or left a call that should have been inlined.
+# The headers' static_asserts on is_zero_overhead_wrapper_v remain the cheap check, that the wrappers have the layout
+#    of their value types; this script checks the code compiled for them.
+# Usage: check_codegen.sh
+# The compiler is taken from $CXX, defaulting to c++, and the disassembler from $OBJDUMP, defaulting to objdump.
+#    Extra flags, such as -march=native, may be passed through $CXXFLAGS.
+set -eu
+
+here=$(cd "$(dirname "$0")" && pwd)
+compiler=${CXX:-c++}
+disassembler=${OBJDUMP:-objdump}
+build=$(mktemp -d)
+trap 'rm -rf "$build"' EXIT
+
+# Removes everything that differs between two equally good builds, so that only the instructions of each function
+#    remain: the file name, addresses, raw bytes and address comments, alignment padding, and register allocation.
+#    General purpose registers are renamed %r, vector registers keep their width, e.g. %xmm, and moves between
+#    registers are dropped, since the two builds number their temporaries differently and the register allocator
+#    breaks ties accordingly. Branch targets keep only their function, e.g. <codegen_add>.
+#    Spills and reloads still show up as moves to and from (%rsp), and missing vectorization as scalar instructions.
+normalize() {
+   "$disassembler" -d --no-show-raw-insn "$1" \
+      | sed -e '/file format/d' -e 's/^ *[0-9a-f]*:[[:space:]]*//' -e 's/^[0-9a-f]* </</' \
+         -e 's/[[:space:]]*#.*$//' -e 's/[0-9a-f][0-9a-f]* <\([^+>]*\)[^>]*>$/<\1>/' \
+         -e '/^\(data16 \|cs \)*nop/d' -e '/^xchg *%ax,%ax$/d' \
+         -e 's/%rsp/%SP/g' -e 's/%rip/%IP/g' -e 's/%\([xyz]\)mm[0-9][0-9]*/%V\1/g' -e 's/%[a-z][a-z0-9]*/%r/g' \
+         -e 's/%SP/%rsp/g' -e 's/%IP/%rip/g' -e 's/%V\([xyz]\)/%\1mm/g' -e '/^v\{0,1\}mov[a-z]* *%[a-z]*,%[a-z]*$/d'
+}
+
+status=0
+for level in O2 O3; do
+   for wrapped in 0 1; do
+      "$compiler" -std=c++20 "-$level" ${CXXFLAGS:-} "-DRGF_CODEGEN_WRAPPED=$wrapped" \
+         -c "$here/CodegenKernels.cpp" -o "$build/kernels_$wrapped.o"
+      normalize "$build/kernels_$wrapped.o" > "$build/kernels_$wrapped.s"
+   done
+   if diff -u "$build/kernels_0.s" "$build/kernels_1.s" > "$build/kernels.diff"; then
+      printf '%s: %s kernels identical\n' "-$level" "$(grep -c '^<' "$build/kernels_0.s")"
+   else
+      printf '%s: wrapped kernels differ from raw kernels\n' "-$level"
+      cat "$build/kernels.diff"
+      status=1
+   fi
+done
+exit $status
@@ -0,0 +1,164 @@
+#!/usr/bin/env python3
+"""Compile-time benchmark for the metaprogramming in Dimension.hpp.
+
+Generates translation units that each exercise one part of the dimension machinery over many distinct dimensions,
+compiles every unit with each available compiler, and prints compile time and peak compiler memory as JSON.
+
+Workloads:
+   baseline          only names every dimension, as a reference for the cost of parsing the generated types
+   product_quotient  dimension_product_t and dimension_quotient_t of neighbouring dimensions
+   power             rational dimension_exponent_t powers, which go through the is_valid_power fold
+   empty_dimension   the rgf::empty_dimension concept
+   unit_type         the rgf::unit_type requirement on linear_unit and quantity, as checked by quantity::get
+
+Every workload is generated once per base count, so the cost of each part can be seen as base_types_t grows.
+Subtract the baseline of the same compiler and base count to get the cost of the workload itself.
+
+Example:
+   ./compile_time_benchmark.py --count 2000 --bases 7 16 32 --output results.json
+
+Compilers default to g++ and clang++, whichever are found on PATH. Requires a POSIX system for os.wait4.
+"""
+
+import argparse
+import json
+import os
+import shutil
+import subprocess
+import sys
+import tempfile
+import time
+
+HERE = os.path.dirname(os.path.abspath(__file__))
+INCLUDE = os.path.dirname(HERE)
+
+WORKLOADS = ("baseline", "product_quotient", "power", "empty_dimension", "unit_type")
+
+
+def exponent(index, base):
+    """Exponent of base in the index'th dimension: the base-5 digits of index, shifted into [-2, 2].
+
+    Digits past the seventh are reused, so every index below 5^7 maps to a distinct dimension for every base count.
+    """
+    return (index // 5 ** (base % 7)) % 5 - 2
+
+
+def dimension(index, bases, scale=1):
+    exponents = ", ".join("b%d<%d>" % (base, scale * exponent(index, base)) for base in range(bases))
+    return "rgf::dimension_t<%s>" % exponents
+
+
+def generate(workload, bases, count):
+    """Returns the source of one benchmark translation unit."""
+    lines = [
+        "// Generated by compile_time_benchmark.py: workload %s, %d bases, %d dimensions." % (workload, bases, count),
+        '#include "LinearUnit.hpp"',
+        "",
+        "namespace bench",
+        "{",
+    ]
+    lines += ["   template<int> struct b%d;" % base for base in range(bases)]
+    lines.append("")
+    if workload == "power":
+        lines.append("   template<typename DIM>")
+        lines.append("   concept has_cube_root = requires { typename rgf::dimension_exponent_t<DIM, 1, 3>; };")
+        lines.append("")
+    for i in range(count):
+        if workload == "baseline":
+            lines.append("   static_assert(rgf::dimension_type<%s>);" % dimension(i, bases))
+        elif workload == "product_quotient":
+            left = dimension(i, bases)
+            right = dimension(i + 1, bases)
+            lines.append("   using p%d = rgf::dimension_product_t<%s, %s>;" % (i, left, right))
+            lines.append("   using q%d = rgf::dimension_quotient_t<%s, %s>;" % (i, left, right))
+        elif workload == "power":
+            # Doubled exponents keep the square root valid, and the 1/3 power exercises a failing fold.
+            doubled = dimension(i, bases, 2)
+            lines.append("   using r%d = rgf::dimension_exponent_t<%s, 1, 2>;" % (i, doubled))
+            lines.append("   using c%d = rgf::dimension_exponent_t<%s, 3, 2>;" % (i, doubled))
+            lines.append("   static_assert(!has_cube_root<%s>);" % doubled)
+        elif workload == "empty_dimension":
+            lines.append("   static_assert(!rgf::empty_dimension<%s>);" % dimension(i, bases))
+        elif workload == "unit_type":
+            dim = dimension(i, bases)
+            lines.append("   static_assert(rgf::unit_type<rgf::linear_unit<%s>, rgf::quantity<%s>>);" % (dim, dim))
+        else:
+            raise ValueError("unknown workload " + workload)
+    lines += ["}", ""]
+    return "\n".join(lines)
+
+
+def measure(command):
+    """Runs command and returns (seconds, peak resident memory in KiB), or raises on failure."""
+    # Diagnostics go to a file rather than a pipe, so a compiler with a lot to say cannot block on a full pipe.
+    with tempfile.TemporaryFile() as diagnostics:
+        start = time.perf_counter()
+        process = subprocess.Popen(command, stderr=diagnostics)
+        # wait4 reports the peak of the driver and the compiler processes it waited for.
+        _, status, usage = os.wait4(process.pid, 0)
+        elapsed = time.perf_counter() - start
+        diagnostics.seek(0)
+        errors = diagnostics.read().decode(errors="replace")
+    if not os.WIFEXITED(status) or os.WEXITSTATUS(status) != 0:
+        raise RuntimeError("%s failed:\n%s" % (" ".join(command), errors))
+    return elapsed, usage.ru_maxrss
+
+
+def compiler_version(compiler):
+    output = subprocess.run([compiler, "--version"], capture_output=True, text=True).stdout
+    return output.splitlines()[0] if output else compiler
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__, formatter_class=argparse.RawDescriptionHelpFormatter)
+    parser.add_argument("--count", type=int, default=2000, help="distinct dimensions per translation unit")
+    parser.add_argument("--bases", type=int, nargs="+", default=[7, 16, 32], help="base counts to generate")
+    parser.add_argument("--workloads", nargs="+", default=list(WORKLOADS), choices=WORKLOADS)
+    parser.add_argument("--compilers", nargs="+", help="compilers to run, default g++ and clang++ if found")
+    parser.add_argument("--repetitions", type=int, default=3, help="compiles per measurement, the fastest is kept")
+    parser.add_argument("--flags", default="-std=c++20 -fsyntax-only", help="compiler flags, split on whitespace")
+    parser.add_argument("--keep-sources", metavar="DIR", help="write the generated sources to DIR and keep them")
+    parser.add_argument("--output", help="write the JSON results to this file instead of stdout")
+    arguments = parser.parse_args()
+
+    compilers = arguments.compilers or [c for c in ("g++", "clang++") if shutil.which(c)]
+    if not compilers:
+        sys.exit("No compiler found; pass one with --compilers.")
+
+    source_dir = arguments.keep_sources or tempfile.mkdtemp(prefix="rgf_compile_time_")
+    os.makedirs(source_dir, exist_ok=True)
+
+    results = []
+    try:
+        for bases in arguments.bases:
+            for workload in arguments.workloads:
+                path = os.path.join(source_dir, "%s_%d.cpp" % (workload, bases))
+                with open(path, "w") as source:
+                    source.write(generate(workload, bases, arguments.count))
+                for compiler in compilers:
+                    command = [compiler] + arguments.flags.split() + ["-I" + INCLUDE, path]
+                    runs = [measure(command) for _ in range(arguments.repetitions)]
+                    results.append({
+                        "compiler": compiler_version(compiler),
+                        "workload": workload,
+                        "bases": bases,
+                        "dimensions": arguments.count,
+                        "seconds": round(min(run[0] for run in runs), 4),
+                        "peak_memory_kib": max(run[1] for run in runs),
+                    })
+                    print("%-16s %-8s bases %-3d %8.3f s %8d KiB" % (workload, compiler, bases,
+                        results[-1]["seconds"], results[-1]["peak_memory_kib"]), file=sys.stderr)
+    finally:
+        if not arguments.keep_sources:
+            shutil.rmtree(source_dir)
+
+    report = json.dumps({"flags": arguments.flags, "repetitions": arguments.repetitions, "results": results}, indent=2)
+    if arguments.output:
+        with open(arguments.output, "w") as output:
+            output.write(report + "\n")
+    else:
+        print(report)
+
+
+if __name__ == "__main__":
+    main()
@@ -0,0 +1,29 @@
+#!/bin/sh
+# Builds QuantityBenchmark.cpp at -O0, -O2 and -O3 and prints the combined results as a JSON array.
+# Usage: run_benchmarks.sh [output.json]
+# The compiler is taken from $CXX, defaulting to c++. Extra flags may be passed through $CXXFLAGS.
+set -eu
+
+here=$(cd "$(dirname "$0")" && pwd)
+compiler=${CXX:-c++}
+build=$(mktemp -d)
+trap 'rm -rf "$build"' EXIT
+
+{
+   printf '[\n'
+   separator=''
+   for level in O0 O2 O3; do
+      "$compiler" -std=c++20 "-$level" ${CXXFLAGS:-} "-DRGF_BENCHMARK_OPTIMIZATION=\"$level\"" \
+         -I"$here/.." "$here/QuantityBenchmark.cpp" -o "$build/QuantityBenchmark_$level"
+      printf '%s' "$separator"
+      "$build/QuantityBenchmark_$level"
+      separator=','
+   done
+   printf ']\n'
+} > "$build/results.json"
+
+if [ $# -ge 1 ]; then
+   cp "$build/results.json" "$1"
+else
+   cat "$build/results.json"
+fi
@@ -3,12 +3,17 @@
 #include "Dimension.hpp"
 #include "LinearUnit.hpp"
 #include "Quantity.hpp"
+#include "StaticLinearUnit.hpp"
+
+#include <string_view>
 
 namespace rgf
 {
 #define DEFINE_ALIASES(NAME)                                                                  \
    template<typename T> using NAME##_quantity_t = rgf::quantity<NAME##_dimension, T>;         \
    template<typename T> using linear_##NAME##_unit_t = rgf::linear_unit<NAME##_dimension, T>; \
+   template<typename RATIO, typename T = double>                                              \
+   using static_##NAME##_unit_t = rgf::static_linear_unit<NAME##_dimension, RATIO, T>;       \
    using NAME##_quantity = NAME##_quantity_t<double>;                                         \
    using linear_##NAME##_unit = rgf::linear_##NAME##_unit_t<double>
 
@@ -27,8 +32,28 @@ namespace rgf
    template<int> struct charge;
    template<int> struct temperature;
 
+   template<> constexpr std::string_view dimension_base_name_v<length> = "length";
+   template<> constexpr std::string_view dimension_base_name_v<time> = "time";
+   template<> constexpr std::string_view dimension_base_name_v<mass> = "mass";
+   template<> constexpr std::string_view dimension_base_name_v<angle> = "angle";
+   template<> constexpr std::string_view dimension_base_name_v<data> = "data";
+   template<> constexpr std::string_view dimension_base_name_v<charge> = "charge";
+   template<> constexpr std::string_view dimension_base_name_v<temperature> = "temperature";
+
+   template<> constexpr std::string_view dimension_base_symbol_v<length> = "m";
+   template<> constexpr std::string_view dimension_base_symbol_v<time> = "s";
+   template<> constexpr std::string_view dimension_base_symbol_v<mass> = "g";
+   template<> constexpr int dimension_base_symbol_power_v<mass> = 3;
+   template<> constexpr std::string_view dimension_base_symbol_v<angle> = "rad";
+   template<> constexpr std::string_view dimension_base_symbol_v<data> = "B";
+   template<> constexpr std::string_view dimension_base_symbol_v<charge> = "C";
+   template<> constexpr std::string_view dimension_base_symbol_v<temperature> = "K";
+
    using standard_bases = rgf::base_types_t<length, time, mass, angle, data, charge, temperature>;
 
+   //! Tag naming standard_bases in a single identifier, for use with rgf::packed_dimension_t.
+   struct standard_system : standard_bases {};
+
    using scalar_dimension = rgf::scalar_dimension_type_t<standard_bases>;
    using length_dimension = rgf::unit_dimension_type_t<standard_bases, length>;
    using time_dimension = rgf::unit_dimension_type_t<standard_bases, time>;
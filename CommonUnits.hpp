@@ -1,8 +1,11 @@
 #pragma once
 
+#include "AffineUnit.hpp"
 #include "CommonDimensions.hpp"
+#include "LogUnit.hpp"
 
 #include <numbers>
+#include <ratio>
 
 namespace rgf
 {
@@ -22,6 +25,22 @@ namespace rgf
 
 #define DEFINE_ALL_SI_PREFIX(BASE_NAME) DEFINE_LARGE_SI_PREFIX(BASE_NAME); DEFINE_SMALL_SI_PREFIX(BASE_NAME)
 
+#define DEFINE_LARGE_STATIC_SI_PREFIX(BASE_NAME) \
+   inline constexpr auto deca##BASE_NAME  = BASE_NAME.scaled_up<std::deca>();  \
+   inline constexpr auto hecto##BASE_NAME = BASE_NAME.scaled_up<std::hecto>(); \
+   inline constexpr auto kilo##BASE_NAME  = BASE_NAME.scaled_up<std::kilo>();  \
+   inline constexpr auto mega##BASE_NAME  = BASE_NAME.scaled_up<std::mega>();  \
+   inline constexpr auto giga##BASE_NAME  = BASE_NAME.scaled_up<std::giga>()
+
+#define DEFINE_SMALL_STATIC_SI_PREFIX(BASE_NAME) \
+   inline constexpr auto deci##BASE_NAME  = BASE_NAME.scaled_down<std::deca>();  \
+   inline constexpr auto centi##BASE_NAME = BASE_NAME.scaled_down<std::hecto>(); \
+   inline constexpr auto milli##BASE_NAME = BASE_NAME.scaled_down<std::kilo>();  \
+   inline constexpr auto micro##BASE_NAME = BASE_NAME.scaled_down<std::mega>();  \
+   inline constexpr auto nano##BASE_NAME  = BASE_NAME.scaled_down<std::giga>()
+
+#define DEFINE_ALL_STATIC_SI_PREFIX(BASE_NAME) DEFINE_LARGE_STATIC_SI_PREFIX(BASE_NAME); DEFINE_SMALL_STATIC_SI_PREFIX(BASE_NAME)
+
    inline constexpr linear_scalar_unit ul{};
 
    inline constexpr linear_length_unit meters{};
@@ -46,5 +65,86 @@ namespace rgf
    inline constexpr linear_angle_unit radians{};
    inline constexpr auto degrees = radians.scaled_down(180 / std::numbers::pi);
 
+   inline constexpr linear_force_unit newtons{};
+
+   //! Data is measured in bytes. SI prefixes are powers of 1000, while kibi-, mebi- and gibi- are powers of 1024.
+   inline constexpr linear_data_unit bytes{};
+   DEFINE_LARGE_SI_PREFIX(bytes);
+   inline constexpr auto kibibytes = bytes.scaled_up(1024);
+   inline constexpr auto mebibytes = kibibytes.scaled_up(1024);
+   inline constexpr auto gibibytes = mebibytes.scaled_up(1024);
+   inline constexpr auto bits = bytes.scaled_down(8);
+   DEFINE_LARGE_SI_PREFIX(bits);
+
+   inline constexpr linear_frequency_unit hertz{};
+   DEFINE_LARGE_SI_PREFIX(hertz);
+
+   //! Kelvins and rankines share the standard zero, so they measure both temperature differences and absolute temperatures.
+   //! Celsius and Fahrenheit are affine units, which only differ from them in their zero.
+   //! E.g. rgf::absolute<rgf::temperature_dimension> t = fahrenheit(98.6); t.get(celsius) is about 37.
+   inline constexpr linear_temperature_unit kelvins{};
+   inline constexpr auto rankines = kelvins.scaled_down(1.8);
+   inline constexpr auto celsius = affine_unit(kelvins).with_origin(273.15);
+   inline constexpr auto fahrenheit = affine_unit(rankines).with_origin(459.67);
+
+   //! Time scales for absolute times, which are measured in seconds of International Atomic Time (TAI) since its
+   //!    1958-01-01 epoch. The TAI and GPS scales are exact, since GPS time runs a constant 19s behind TAI.
+   //! Unix time is UTC, which inserts leap seconds. unix_seconds uses the offset in effect since 2017-01-01,
+   //!    when TAI - UTC became 37s, so it is exact until the next leap second and off by whole seconds before 2017.
+   inline constexpr affine_unit<time_dimension> tai_seconds{};
+   inline constexpr auto gps_seconds = tai_seconds.with_origin(694'656'019);
+   inline constexpr auto unix_seconds = tai_seconds.with_origin(378'691'237);
+
+   //! Logarithmic units. Scalar levels are power ratios, so 1 neper is 20 / ln(10) decibels.
+   //! E.g. rgf::power_quantity p = rgf::to_quantity(dBm(17) + decibels(3)); p.get(dBW) is about -10.
+   //! The references are given by their natural logarithms, which for dBm is ln(0.001).
+   inline constexpr auto decibels = log_unit<scalar_dimension>::from_log_reference(10, 0);
+   inline constexpr auto nepers = log_unit<scalar_dimension>::from_log_reference(std::numbers::ln10 / 2, 0);
+   inline constexpr auto dBW = log_unit<power_dimension>::from_log_reference(10, 0);
+   inline constexpr auto dBm = log_unit<power_dimension>::from_log_reference(10, -6.907755278982137);
+
    // ...
+
+   //! Compile-time versions of the units above.
+   //! Each is a static_linear_unit, so conversions fold to a single constant multiplication.
+   namespace static_units
+   {
+      inline constexpr static_scalar_unit_t<std::ratio<1>> ul{};
+
+      inline constexpr static_length_unit_t<std::ratio<1>> meters{};
+      DEFINE_ALL_STATIC_SI_PREFIX(meters);
+      inline constexpr auto inches = meters.scaled_down<std::ratio<393701, 10000>>();
+      inline constexpr auto feet = inches.scaled_up<std::ratio<12>>();
+      inline constexpr auto yards = inches.scaled_up<std::ratio<36>>();
+      inline constexpr auto miles = feet.scaled_up<std::ratio<5280>>();
+
+      inline constexpr static_time_unit_t<std::ratio<1>> seconds{};
+      DEFINE_SMALL_STATIC_SI_PREFIX(seconds);
+      inline constexpr auto minutes = seconds.scaled_up<std::ratio<60>>();
+      inline constexpr auto hours = minutes.scaled_up<std::ratio<60>>();
+      inline constexpr auto days = hours.scaled_up<std::ratio<24>>();
+      inline constexpr auto weeks = days.scaled_up<std::ratio<7>>();
+      inline constexpr auto years = days.scaled_up<std::ratio<1461, 4>>();
+      inline constexpr auto months = years.scaled_down<std::ratio<12>>();
+
+      inline constexpr static_mass_unit_t<std::milli> grams{};
+      DEFINE_ALL_STATIC_SI_PREFIX(grams);
+
+      inline constexpr static_angle_unit_t<std::ratio<1>> radians{};
+      //! pi / 180 has no exact rational form. This is the smallest convergent that rounds to the same double.
+      inline constexpr auto degrees = radians.scaled_up<std::ratio<14964008, 857374503>>();
+
+      inline constexpr static_force_unit_t<std::ratio<1>> newtons{};
+
+      inline constexpr static_data_unit_t<std::ratio<1>> bytes{};
+      DEFINE_LARGE_STATIC_SI_PREFIX(bytes);
+      inline constexpr auto kibibytes = bytes.scaled_up<std::ratio<1024>>();
+      inline constexpr auto mebibytes = kibibytes.scaled_up<std::ratio<1024>>();
+      inline constexpr auto gibibytes = mebibytes.scaled_up<std::ratio<1024>>();
+      inline constexpr auto bits = bytes.scaled_down<std::ratio<8>>();
+      DEFINE_LARGE_STATIC_SI_PREFIX(bits);
+
+      inline constexpr static_frequency_unit_t<std::ratio<1>> hertz{};
+      DEFINE_LARGE_STATIC_SI_PREFIX(hertz);
+   }
 }
\ No newline at end of file
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "LinearUnit.hpp"
+#include "StaticLinearUnit.hpp"
+
+#include <cassert>
+#include <concepts>
+#include <span>
+#include <type_traits>
+
+namespace rgf
+{
+   //! Helper concept for units that convert to and from standard units by a single multiplicative factor.
+   //! Satisfied by linear_unit and static_linear_unit.
+   template<typename T>
+   concept multiplicative_unit = requires (const T t)
+   {
+      requires dimension_type<typename T::dimension>;
+      requires arithmetic<typename T::value_type>;
+      { t.conversion_factor() } -> std::convertible_to<typename linear_unit<typename T::dimension, typename T::value_type>::factor_type>;
+   };
+
+   //! conversion<FROM_UNIT, TO_UNIT> converts values expressed in one unit directly into another unit.
+   //! The two conversion factors are fused into one when the conversion is constructed,
+   //!    so each conversion is a single multiplication rather than a trip through standard units.
+   //! Integral conversions fuse the factors into an exact rational, and divide through an integer_divider.
+   //! Both units must have the same dimension and value_type.
+   //! E.g. constexpr rgf::conversion milesToKilometers(miles, kilometers);
+   template<multiplicative_unit FROM_UNIT, multiplicative_unit TO_UNIT>
+      requires std::same_as<typename FROM_UNIT::dimension, typename TO_UNIT::dimension>
+         && std::same_as<typename FROM_UNIT::value_type, typename TO_UNIT::value_type>
+   class conversion
+   {
+   public:
+      using from_unit_type = FROM_UNIT;
+      using to_unit_type = TO_UNIT;
+      using dimension = typename from_unit_type::dimension;
+      using value_type = typename from_unit_type::value_type;
+      using factor_type = typename linear_unit<dimension, value_type>::factor_type;
+
+      constexpr conversion(const from_unit_type& aFrom, const to_unit_type& aTo) noexcept
+         : mFactor(fused_factor(aFrom, aTo))
+      {}
+
+      //! Returns the fused conversion factor.
+      constexpr factor_type conversion_factor() const noexcept
+      {
+         return mFactor.get();
+      }
+
+      //! Converts a single value from FROM_UNIT into TO_UNIT.
+      constexpr value_type operator()(value_type aValue) const noexcept
+      {
+         return mFactor.to_standard_value(aValue);
+      }
+
+      //! Batch versions of operator().
+      //! Overload 1 converts aValues in place.
+      //! Overload 2 writes the converted values to aResults, which must be at least as large as aValues.
+      constexpr void convert_values(std::span<value_type> aValues) const noexcept
+      {
+         mFactor.to_standard_values(aValues, aValues);
+      }
+      constexpr void convert_values(std::span<const value_type> aValues, std::span<value_type> aResults) const noexcept
+      {
+         assert(aResults.size() >= aValues.size());
+         mFactor.to_standard_values(aValues, aResults);
+      }
+
+   private:
+      //! Conversions between two static_linear_units are fused exactly at compile time.
+      constexpr static factor_type fused_factor(const from_unit_type& aFrom, const to_unit_type& aTo) noexcept
+      {
+         if constexpr (requires { typename from_unit_type::ratio; typename to_unit_type::ratio; })
+         {
+            using fused = std::ratio_divide<typename from_unit_type::ratio, typename to_unit_type::ratio>;
+            return static_linear_unit<dimension, fused, value_type>::conversion_factor();
+         }
+         else
+         {
+            return factor_type(aFrom.conversion_factor()) / factor_type(aTo.conversion_factor());
+         }
+      }
+
+      //! The fused factor is applied in the "to standard" direction, treating TO_UNIT as the standard unit.
+      rgf::detail::linear_factor<value_type> mFactor;
+   };
+
+   //! Converts aValue from aFrom's unit into aTo's unit with a single fused factor.
+   //! E.g. rgf::convert(26.2, miles, kilometers);
+   template<multiplicative_unit FROM_UNIT, multiplicative_unit TO_UNIT>
+   constexpr auto convert(typename FROM_UNIT::value_type aValue, const FROM_UNIT& aFrom, const TO_UNIT& aTo) noexcept
+   {
+      return conversion(aFrom, aTo)(aValue);
+   }
+
+   //! Batch versions of convert.
+   //! Overload 1 converts aValues in place.
+   //! Overload 2 writes the converted values to aResults, which must be at least as large as aValues.
+   template<multiplicative_unit FROM_UNIT, multiplicative_unit TO_UNIT>
+   constexpr void convert(std::span<typename FROM_UNIT::value_type> aValues, const FROM_UNIT& aFrom, const TO_UNIT& aTo) noexcept
+   {
+      conversion(aFrom, aTo).convert_values(aValues);
+   }
+   template<multiplicative_unit FROM_UNIT, multiplicative_unit TO_UNIT>
+   constexpr void convert(std::span<const typename FROM_UNIT::value_type> aValues,
+      std::span<typename FROM_UNIT::value_type> aResults, const FROM_UNIT& aFrom, const TO_UNIT& aTo) noexcept
+   {
+      conversion(aFrom, aTo).convert_values(aValues, aResults);
+   }
+}
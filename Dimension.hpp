@@ -1,7 +1,12 @@
 #pragma once
 
+#include <array>
 #include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
 #include <type_traits>
+#include <utility>
 
 namespace rgf
 {
@@ -21,8 +26,9 @@ namespace rgf
    struct dimension_t;
 
    //! base_types_t is useful for defining aliases of dimension_t specializations.
+   //! It is a complete type so that short tag classes may derive from it, see rgf::packed_dimension_t.
    template<template<int> typename... BASE_TYPES>
-   struct base_types_t;
+   struct base_types_t {};
 
    //! Boolean constant indicating if a type is a specialization of dimension<...>.
    template<typename>
@@ -34,6 +40,51 @@ namespace rgf
    template<typename T>
    concept dimension_type = is_dimension_v<T>;
 
+   //! Name of a dimension base, used to identify dimensions outside of the type system, e.g. in files.
+   //! Empty unless specialized, e.g. template<> constexpr std::string_view dimension_base_name_v<length> = "length";
+   template<template<int> typename BASE_TYPE>
+   constexpr std::string_view dimension_base_name_v = {};
+
+   //! Symbol of the unprefixed unit of a dimension base, used when formatting quantities in standard units.
+   //! Empty unless specialized, e.g. template<> constexpr std::string_view dimension_base_symbol_v<length> = "m";
+   template<template<int> typename BASE_TYPE>
+   constexpr std::string_view dimension_base_symbol_v = {};
+
+   //! Power of ten of the standard unit of a dimension base, relative to the unit named by dimension_base_symbol_v.
+   //! Zero unless specialized. E.g. the standard unit of mass is the kilogram, so the symbol is "g" and the power is 3.
+   template<template<int> typename BASE_TYPE>
+   constexpr int dimension_base_symbol_power_v = 0;
+
+   namespace detail
+   {
+      //! 64-bit FNV-1a hash of a string, continuing from aHash.
+      constexpr std::uint64_t fnv1a(std::string_view aString, std::uint64_t aHash = 0xCBF2'9CE4'8422'2325) noexcept
+      {
+         for (char c : aString)
+         {
+            aHash = (aHash ^ static_cast<unsigned char>(c)) * 0x0000'0100'0000'01B3;
+         }
+         return aHash;
+      }
+      //! 64-bit FNV-1a hash of the four bytes of aValue, least significant first, continuing from aHash.
+      constexpr std::uint64_t fnv1a(std::int32_t aValue, std::uint64_t aHash) noexcept
+      {
+         for (int i = 0; i < 4; ++i)
+         {
+            aHash = (aHash ^ ((static_cast<std::uint32_t>(aValue) >> (8 * i)) & 0xFF)) * 0x0000'0100'0000'01B3;
+         }
+         return aHash;
+      }
+
+      //! Hashes one base of a dimension into aHash, as used by dimension_id_v.
+      constexpr std::uint64_t hash_dimension_base(std::string_view aName, int aExponent, std::uint64_t aHash) noexcept
+      {
+         aHash = rgf::detail::fnv1a(static_cast<std::int32_t>(aName.size()), aHash);
+         aHash = rgf::detail::fnv1a(aName, aHash);
+         return rgf::detail::fnv1a(static_cast<std::int32_t>(aExponent), aHash);
+      }
+   }
+
    namespace detail
    {
       //! Boolean constant indicating whether (X * NUM / DEN) will give an exact result for every X in SERIES.
@@ -92,6 +143,156 @@ namespace rgf
       };
    }
 
+   namespace detail
+   {
+      //! The 'value' member of dimension_id holds rgf::dimension_id_v<DIM>.
+      template<dimension_type DIM>
+      struct dimension_id;
+      template<template<int> typename... BASE_TYPES, int... EXPONENTS>
+      struct dimension_id<dimension_t<BASE_TYPES<EXPONENTS>...>>
+      {
+         static_assert((!rgf::dimension_base_name_v<BASE_TYPES>.empty() && ...),
+            "Every base must specialize rgf::dimension_base_name_v to have a dimension id.");
+
+         constexpr static std::uint64_t value = []
+         {
+            std::uint64_t hash = rgf::detail::fnv1a(std::string_view());
+            ((hash = rgf::detail::hash_dimension_base(rgf::dimension_base_name_v<BASE_TYPES>, EXPONENTS, hash)), ...);
+            return hash;
+         }();
+      };
+
+      //! Returns the SI prefix for 10^aPower, or an empty string for 0 or powers without a prefix in CommonUnits.hpp.
+      constexpr std::string_view si_prefix(int aPower) noexcept
+      {
+         switch (aPower)
+         {
+         case 9: return "G";
+         case 6: return "M";
+         case 3: return "k";
+         case 2: return "h";
+         case 1: return "da";
+         case -1: return "d";
+         case -2: return "c";
+         case -3: return "m";
+         case -6: return "µ";
+         case -9: return "n";
+         default: return {};
+         }
+      }
+
+      //! One base of a dimension symbol: the prefixed symbol of its standard unit, and its exponent.
+      struct dimension_symbol_term
+      {
+         std::string_view prefix;
+         std::string_view symbol;
+         int exponent;
+
+         //! Orders terms with positive exponents first, then alphabetically by prefixed symbol.
+         constexpr bool precedes(const dimension_symbol_term& aOther) const noexcept
+         {
+            if ((exponent < 0) != (aOther.exponent < 0))
+            {
+               return exponent > 0;
+            }
+            const auto character = [](const dimension_symbol_term& aTerm, std::size_t aIndex)
+            {
+               return aIndex < aTerm.prefix.size() ? aTerm.prefix[aIndex] : aTerm.symbol[aIndex - aTerm.prefix.size()];
+            };
+            const std::size_t size = prefix.size() + symbol.size();
+            const std::size_t otherSize = aOther.prefix.size() + aOther.symbol.size();
+            for (std::size_t i = 0; i < size && i < otherSize; ++i)
+            {
+               if (character(*this, i) != character(aOther, i))
+               {
+                  return character(*this, i) < character(aOther, i);
+               }
+            }
+            return size < otherSize;
+         }
+      };
+
+      //! Writes the canonical symbol of aTerms to aOutput, or only measures it if aOutput is null, and returns its length.
+      //! Terms are sorted by dimension_symbol_term::precedes, joined by '·', and exponents other than one are written in superscript.
+      template<std::size_t N>
+      constexpr std::size_t write_dimension_symbol(std::array<dimension_symbol_term, N> aTerms, char* aOutput) noexcept
+      {
+         constexpr std::string_view superscripts[] = { "⁰", "¹", "²", "³", "⁴", "⁵", "⁶", "⁷", "⁸", "⁹" };
+         for (std::size_t i = 1; i < N; ++i)
+         {
+            for (std::size_t j = i; j > 0 && aTerms[j].precedes(aTerms[j - 1]); --j)
+            {
+               std::swap(aTerms[j], aTerms[j - 1]);
+            }
+         }
+
+         std::size_t size = 0;
+         const auto write = [&](std::string_view aText)
+         {
+            for (char c : aText)
+            {
+               if (aOutput)
+               {
+                  aOutput[size] = c;
+               }
+               ++size;
+            }
+         };
+         for (const dimension_symbol_term& term : aTerms)
+         {
+            if (term.exponent == 0)
+            {
+               continue;
+            }
+            if (size > 0)
+            {
+               write("·");
+            }
+            write(term.prefix);
+            write(term.symbol);
+            if (term.exponent != 1)
+            {
+               if (term.exponent < 0)
+               {
+                  write("⁻");
+               }
+               const int magnitude = term.exponent < 0 ? -term.exponent : term.exponent;
+               int divisor = 1;
+               while (divisor * 10 <= magnitude)
+               {
+                  divisor *= 10;
+               }
+               for (; divisor > 0; divisor /= 10)
+               {
+                  write(superscripts[magnitude / divisor % 10]);
+               }
+            }
+         }
+         return size;
+      }
+
+      //! The 'value' member of dimension_symbol holds the characters of rgf::dimension_symbol_v<DIM>, followed by a null terminator.
+      template<dimension_type DIM>
+      struct dimension_symbol;
+      template<template<int> typename... BASE_TYPES, int... EXPONENTS>
+      struct dimension_symbol<dimension_t<BASE_TYPES<EXPONENTS>...>>
+      {
+         static_assert((!rgf::dimension_base_symbol_v<BASE_TYPES>.empty() && ...),
+            "Every base must specialize rgf::dimension_base_symbol_v to have a dimension symbol.");
+
+         constexpr static std::array<dimension_symbol_term, sizeof...(BASE_TYPES)> terms = {
+            dimension_symbol_term{ rgf::detail::si_prefix(rgf::dimension_base_symbol_power_v<BASE_TYPES>),
+               rgf::dimension_base_symbol_v<BASE_TYPES>, EXPONENTS }... };
+         constexpr static std::size_t size = rgf::detail::write_dimension_symbol(terms, nullptr);
+         constexpr static std::array<char, size + 1> value = []
+         {
+            std::array<char, size + 1> result{};
+            rgf::detail::write_dimension_symbol(terms, result.data());
+            return result;
+         }();
+      };
+   }
+
    //! Alias representing the multiplicative inverse of DIM.
    template<dimension_type DIM>
    using dimension_inverse_t = typename rgf::detail::dimension_exponent<DIM, -1>::type;
@@ -113,6 +314,20 @@ namespace rgf
    template<typename DIM>
    concept empty_dimension = std::same_as<DIM, dimension_exponent_t<DIM, 0>>;
 
+   //! 64-bit fingerprint of DIM, computed from the names and exponents of its bases, in order.
+   //! It is the same in every build and on every compiler, so it can identify dimensions in data shared between processes.
+   //! Every base must specialize dimension_base_name_v.
+   template<dimension_type DIM>
+   constexpr std::uint64_t dimension_id_v = rgf::detail::dimension_id<DIM>::value;
+
+   //! Canonical symbol of the standard unit of DIM, computed at compile time, e.g. "kg·m·s⁻²" for force.
+   //! Bases with positive exponents come first, then those with negative exponents, each group sorted by symbol.
+   //! Bases are written with dimension_base_symbol_v, prefixed according to dimension_base_symbol_power_v,
+   //!    and exponents other than one are written in superscript. Scalars have an empty symbol.
+   //! The characters are null-terminated, so data() may be passed to C APIs.
+   template<dimension_type DIM>
+   constexpr std::string_view dimension_symbol_v(rgf::detail::dimension_symbol<DIM>::value.data(), rgf::detail::dimension_symbol<DIM>::size);
+
    //! Alias representing a dimension with all zero exponents.
    template<typename BASE_TYPES_T>
    using scalar_dimension_type_t = typename rgf::detail::scalar_dimension_type<BASE_TYPES_T>::type;
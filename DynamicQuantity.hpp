@@ -0,0 +1,210 @@
+#pragma once
+
+#include "Quantity.hpp"
+#include "RuntimeDimension.hpp"
+
+#include <compare>
+#include <stdexcept>
+#include <string>
+
+namespace rgf
+{
+   //! Thrown when dynamic quantities with different dimensions are combined, or converted to the wrong static dimension.
+   class dimension_error : public std::runtime_error
+   {
+   public:
+      using std::runtime_error::runtime_error;
+   };
+
+   namespace detail
+   {
+      //! A separate [[noreturn]] function, so that compilers treat the throwing path as cold,
+      //!    and the checks in dynamic_quantity stay a compare and a branch.
+      [[noreturn]] inline void throw_dimension_error(const char* aOperation)
+      {
+         throw rgf::dimension_error(std::string("Dimension mismatch in ") + aOperation);
+      }
+   }
+
+   //! dynamic_quantity<BASE_SYSTEM, VALUE_TYPE> is a quantity whose dimension is only known at runtime,
+   //!    e.g. when units come from configuration files or user input.
+   //! It stores the value in standard units next to a runtime_dimension.
+   //! Sums, differences and orderings check that the dimensions match with a single integer compare,
+   //!    and throw dimension_error if not. Products and quotients combine the dimensions with a SWAR add or subtract.
+   //! It converts implicitly from any quantity over BASE_SYSTEM, and back with as<DIM>(), which checks the dimension.
+   template<base_system BASE_SYSTEM, arithmetic VALUE_TYPE = double>
+   class dynamic_quantity
+   {
+   public:
+      using base_system_type = BASE_SYSTEM;
+      using value_type = VALUE_TYPE;
+      using runtime_dimension_type = runtime_dimension<base_system_type>;
+
+      //! When default-constructed, the quantity is a scalar, and the standard value is value-initialized.
+      constexpr dynamic_quantity() = default;
+
+      //! Constructs a quantity of the given dimension, from a value in standard units.
+      constexpr dynamic_quantity(value_type aStandardValue, runtime_dimension_type aDimension) noexcept
+         : mStandardValue(aStandardValue)
+         , mDimension(aDimension)
+      {}
+
+      //! Static quantities are implicitly convertible to dynamic quantities.
+      template<rgf::dimension_type DIM>
+      constexpr dynamic_quantity(const quantity<DIM, value_type>& aQuantity) noexcept
+         : mStandardValue(aQuantity.get_standard())
+         , mDimension(runtime_dimension_type::template of<DIM>())
+      {}
+
+      constexpr value_type get_standard() const noexcept
+      {
+         return mStandardValue;
+      }
+      constexpr void set_standard_value(value_type aValue) noexcept
+      {
+         mStandardValue = aValue;
+      }
+      constexpr runtime_dimension_type dimension() const noexcept
+      {
+         return mDimension;
+      }
+
+      //! Returns true if the quantity has dimension DIM.
+      template<rgf::dimension_type DIM>
+      constexpr bool has_dimension() const noexcept
+      {
+         return mDimension == runtime_dimension_type::template of<DIM>();
+      }
+
+      //! Converts to a static quantity.
+      //! Throws dimension_error if the quantity does not have dimension DIM.
+      template<rgf::dimension_type DIM>
+      constexpr quantity<DIM, value_type> as() const
+      {
+         if (!has_dimension<DIM>())
+         {
+            rgf::detail::throw_dimension_error("as");
+         }
+         return { std::in_place, mStandardValue };
+      }
+      template<rgf::dimension_type DIM>
+      constexpr explicit operator quantity<DIM, value_type>() const
+      {
+         return as<DIM>();
+      }
+
+      //! Converts to a value in aUnit.
+      //! Throws dimension_error if the quantity does not have aUnit's dimension.
+      template<typename UNIT>
+         requires unit_type<UNIT, quantity<typename UNIT::dimension, value_type>>
+      constexpr auto get(const UNIT& aUnit) const
+      {
+         return aUnit.get(as<typename UNIT::dimension>());
+      }
+
+      constexpr dynamic_quantity operator+() const noexcept
+      {
+         return *this;
+      }
+      constexpr dynamic_quantity operator-() const noexcept
+      {
+         return { -mStandardValue, mDimension };
+      }
+
+      //! In-place arithmetic.
+      //! Addition and subtraction throw dimension_error if the dimensions differ.
+      constexpr dynamic_quantity& operator+=(const dynamic_quantity& aOther)
+      {
+         check_same_dimension(aOther, "operator+=");
+         mStandardValue += aOther.mStandardValue;
+         return *this;
+      }
+      constexpr dynamic_quantity& operator-=(const dynamic_quantity& aOther)
+      {
+         check_same_dimension(aOther, "operator-=");
+         mStandardValue -= aOther.mStandardValue;
+         return *this;
+      }
+      constexpr dynamic_quantity& operator*=(const dynamic_quantity& aOther) noexcept
+      {
+         mStandardValue *= aOther.mStandardValue;
+         mDimension = mDimension * aOther.mDimension;
+         return *this;
+      }
+      constexpr dynamic_quantity& operator/=(const dynamic_quantity& aOther) noexcept
+      {
+         mStandardValue /= aOther.mStandardValue;
+         mDimension = mDimension / aOther.mDimension;
+         return *this;
+      }
+      constexpr dynamic_quantity& operator*=(value_type aValue) noexcept
+      {
+         mStandardValue *= aValue;
+         return *this;
+      }
+      constexpr dynamic_quantity& operator/=(value_type aValue) noexcept
+      {
+         mStandardValue /= aValue;
+         return *this;
+      }
+
+      //! Arithmetic operators.
+      //! Addition and subtraction throw dimension_error if the dimensions differ.
+      constexpr friend dynamic_quantity operator+(dynamic_quantity aLeft, const dynamic_quantity& aRight)
+      {
+         return aLeft += aRight;
+      }
+      constexpr friend dynamic_quantity operator-(dynamic_quantity aLeft, const dynamic_quantity& aRight)
+      {
+         return aLeft -= aRight;
+      }
+      constexpr friend dynamic_quantity operator*(dynamic_quantity aLeft, const dynamic_quantity& aRight) noexcept
+      {
+         return aLeft *= aRight;
+      }
+      constexpr friend dynamic_quantity operator/(dynamic_quantity aLeft, const dynamic_quantity& aRight) noexcept
+      {
+         return aLeft /= aRight;
+      }
+      constexpr friend dynamic_quantity operator*(dynamic_quantity aLeft, value_type aRight) noexcept
+      {
+         return aLeft *= aRight;
+      }
+      constexpr friend dynamic_quantity operator*(value_type aLeft, dynamic_quantity aRight) noexcept
+      {
+         return aRight *= aLeft;
+      }
+      constexpr friend dynamic_quantity operator/(dynamic_quantity aLeft, value_type aRight) noexcept
+      {
+         return aLeft /= aRight;
+      }
+      constexpr friend dynamic_quantity operator/(value_type aLeft, const dynamic_quantity& aRight) noexcept
+      {
+         return { aLeft / aRight.mStandardValue, aRight.mDimension.inverse() };
+      }
+
+      //! Comparison operators.
+      //! Quantities with different dimensions are never equal, and ordering them throws dimension_error.
+      constexpr friend bool operator==(const dynamic_quantity& aLeft, const dynamic_quantity& aRight) noexcept
+      {
+         return aLeft.mDimension == aRight.mDimension && aLeft.mStandardValue == aRight.mStandardValue;
+      }
+      constexpr friend auto operator<=>(const dynamic_quantity& aLeft, const dynamic_quantity& aRight)
+      {
+         aLeft.check_same_dimension(aRight, "operator<=>");
+         return aLeft.mStandardValue <=> aRight.mStandardValue;
+      }
+
+   private:
+      constexpr void check_same_dimension(const dynamic_quantity& aOther, const char* aOperation) const
+      {
+         if (mDimension != aOther.mDimension) [[unlikely]]
+         {
+            rgf::detail::throw_dimension_error(aOperation);
+         }
+      }
+
+      value_type mStandardValue = value_type();
+      runtime_dimension_type mDimension;
+   };
+}
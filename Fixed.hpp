@@ -0,0 +1,353 @@
+#pragma once
+
+#include "Quantity.hpp"
+
+#include <cassert>
+#include <compare>
+#include <concepts>
+#include <cstdint>
+#include <type_traits>
+
+namespace rgf
+{
+   namespace detail
+   {
+      //! The 'type' member alias of fixed_integers is the signed integer type with exactly BITS bits,
+      //!    and 'wide_type' is a signed integer type twice as wide, used for intermediate products and quotients.
+      template<int BITS>
+      struct fixed_integers;
+      template<>
+      struct fixed_integers<8>
+      {
+         using type = std::int8_t;
+         using wide_type = std::int16_t;
+      };
+      template<>
+      struct fixed_integers<16>
+      {
+         using type = std::int16_t;
+         using wide_type = std::int32_t;
+      };
+      template<>
+      struct fixed_integers<32>
+      {
+         using type = std::int32_t;
+         using wide_type = std::int64_t;
+      };
+#if defined(__SIZEOF_INT128__)
+      template<>
+      struct fixed_integers<64>
+      {
+         using type = std::int64_t;
+         __extension__ using wide_type = __int128;
+      };
+#endif
+
+      //! Boolean constant indicating if fixed<BITS, FRAC_BITS> is supported.
+      template<int BITS, int FRAC_BITS>
+      constexpr bool is_valid_fixed_v = requires { typename fixed_integers<BITS>::wide_type; }
+         && FRAC_BITS >= 0 && FRAC_BITS < BITS;
+
+      //! Returns 2^aExponent, exactly.
+      template<std::floating_point T>
+      constexpr T power_of_two(int aExponent) noexcept
+      {
+         T result = 1;
+         for (; aExponent > 0; --aExponent)
+         {
+            result *= 2;
+         }
+         for (; aExponent < 0; ++aExponent)
+         {
+            result /= 2;
+         }
+         return result;
+      }
+   }
+
+   //! fixed<BITS, FRAC_BITS> is a signed binary fixed-point number: a BITS-bit integer scaled by 2^-FRAC_BITS.
+   //! Every operation is integer arithmetic, so results are bit-identical on every platform and compiler.
+   //! It may be used as the value_type of quantity, linear_unit, static_linear_unit and absolute.
+   //! BITS must be 8, 16, 32 or 64, and 0 <= FRAC_BITS < BITS. 64 bits requires a compiler with 128-bit integers.
+   //! Intermediate results are computed in an integer twice as wide, then narrowed, so overflow wraps around.
+   //! Products are rounded to nearest, quotients are truncated towards zero.
+   //! E.g. rgf::length_quantity_t<rgf::fixed<32, 16>> is a length with a resolution of 1/65536 meters.
+   template<int BITS, int FRAC_BITS>
+      requires rgf::detail::is_valid_fixed_v<BITS, FRAC_BITS>
+   class fixed
+   {
+   public:
+      using raw_type = typename rgf::detail::fixed_integers<BITS>::type;
+      using wide_type = typename rgf::detail::fixed_integers<BITS>::wide_type;
+
+      constexpr static int bits = BITS;
+      constexpr static int frac_bits = FRAC_BITS;
+
+      //! When default-constructed, the value is zero.
+      constexpr fixed() noexcept = default;
+
+      //! Explicitly convertible from integers, and from floating point values rounded to nearest.
+      //! The value must be representable.
+      template<std::integral T>
+      constexpr explicit fixed(T aValue) noexcept
+         : mRaw(static_cast<raw_type>(static_cast<wide_type>(aValue) * (wide_type(1) << FRAC_BITS)))
+      {}
+      template<std::floating_point T>
+      constexpr explicit fixed(T aValue) noexcept
+         : mRaw(static_cast<raw_type>(round(aValue * rgf::detail::power_of_two<T>(FRAC_BITS))))
+      {}
+
+      //! Explicitly convertible from other fixed-point types.
+      //! Fractional bits that do not fit are dropped, rounding towards negative infinity.
+      template<int OTHER_BITS, int OTHER_FRAC_BITS>
+      constexpr explicit fixed(const fixed<OTHER_BITS, OTHER_FRAC_BITS>& aOther) noexcept
+         : mRaw(convert_raw<OTHER_FRAC_BITS>(aOther.raw()))
+      {}
+
+      //! Constructs the value with the given underlying integer, i.e. aRaw * 2^-FRAC_BITS.
+      constexpr static fixed from_raw(raw_type aRaw) noexcept
+      {
+         fixed result;
+         result.mRaw = aRaw;
+         return result;
+      }
+      constexpr raw_type raw() const noexcept
+      {
+         return mRaw;
+      }
+
+      //! Explicitly convertible to floating point types, exactly if the type has enough precision.
+      template<std::floating_point T>
+      constexpr explicit operator T() const noexcept
+      {
+         return static_cast<T>(mRaw) * rgf::detail::power_of_two<T>(-FRAC_BITS);
+      }
+      //! Explicitly convertible to integers, rounding towards negative infinity.
+      template<std::integral T>
+      constexpr explicit operator T() const noexcept
+      {
+         return static_cast<T>(mRaw >> FRAC_BITS);
+      }
+
+      constexpr fixed operator+() const noexcept
+      {
+         return *this;
+      }
+      constexpr fixed operator-() const noexcept
+      {
+         return from_raw(static_cast<raw_type>(-static_cast<wide_type>(mRaw)));
+      }
+
+      //! In-place arithmetic with the same fixed-point type, and scaling by integers.
+      constexpr fixed& operator+=(const fixed& aOther) noexcept
+      {
+         return *this = *this + aOther;
+      }
+      constexpr fixed& operator-=(const fixed& aOther) noexcept
+      {
+         return *this = *this - aOther;
+      }
+      constexpr fixed& operator*=(const fixed& aOther) noexcept
+      {
+         return *this = *this * aOther;
+      }
+      constexpr fixed& operator/=(const fixed& aOther) noexcept
+      {
+         return *this = *this / aOther;
+      }
+      template<std::integral T>
+      constexpr fixed& operator*=(T aScale) noexcept
+      {
+         return *this = *this * aScale;
+      }
+      template<std::integral T>
+      constexpr fixed& operator/=(T aScale) noexcept
+      {
+         return *this = *this / aScale;
+      }
+
+      //! Scaling by integers.
+      //! Quotients are truncated towards zero, and the divisor must not be zero.
+      template<std::integral T>
+      constexpr friend fixed operator*(const fixed& aLeft, T aRight) noexcept
+      {
+         return from_raw(static_cast<raw_type>(static_cast<wide_type>(aLeft.mRaw) * static_cast<wide_type>(aRight)));
+      }
+      template<std::integral T>
+      constexpr friend fixed operator*(T aLeft, const fixed& aRight) noexcept
+      {
+         return aRight * aLeft;
+      }
+      template<std::integral T>
+      constexpr friend fixed operator/(const fixed& aLeft, T aRight) noexcept
+      {
+         return from_raw(static_cast<raw_type>(static_cast<wide_type>(aLeft.mRaw) / static_cast<wide_type>(aRight)));
+      }
+      template<std::integral T>
+      constexpr friend fixed operator/(T aLeft, const fixed& aRight) noexcept
+      {
+         return fixed(aLeft) / aRight;
+      }
+
+      constexpr friend bool operator==(const fixed&, const fixed&) noexcept = default;
+      constexpr friend auto operator<=>(const fixed&, const fixed&) noexcept = default;
+
+   private:
+      template<int OTHER_FRAC_BITS, std::integral T>
+      constexpr static raw_type convert_raw(T aRaw) noexcept
+      {
+         if constexpr (OTHER_FRAC_BITS <= FRAC_BITS)
+         {
+            return static_cast<raw_type>(static_cast<wide_type>(aRaw) * (wide_type(1) << (FRAC_BITS - OTHER_FRAC_BITS)));
+         }
+         else
+         {
+            return static_cast<raw_type>(aRaw >> (OTHER_FRAC_BITS - FRAC_BITS));
+         }
+      }
+
+      //! Rounds half away from zero, without relying on the rounding mode.
+      template<std::floating_point T>
+      constexpr static T round(T aValue) noexcept
+      {
+         return aValue < 0 ? -static_cast<T>(static_cast<wide_type>(-aValue + T(0.5)))
+            : static_cast<T>(static_cast<wide_type>(aValue + T(0.5)));
+      }
+
+      raw_type mRaw = 0;
+   };
+
+   //! Boolean constant indicating if a type is a specialization of fixed.
+   template<typename>
+   constexpr bool is_fixed_v = false;
+   template<int BITS, int FRAC_BITS>
+   constexpr bool is_fixed_v<fixed<BITS, FRAC_BITS>> = true;
+
+   //! Alias representing the result type of arithmetic between two fixed-point types.
+   //! It has the larger size, and the larger number of fractional bits, of the two.
+   template<typename LEFT_FIXED, typename RIGHT_FIXED>
+   using common_fixed_t = fixed<(LEFT_FIXED::bits > RIGHT_FIXED::bits ? LEFT_FIXED::bits : RIGHT_FIXED::bits),
+      (LEFT_FIXED::frac_bits > RIGHT_FIXED::frac_bits ? LEFT_FIXED::frac_bits : RIGHT_FIXED::frac_bits)>;
+
+   //! Arithmetic between fixed-point types.
+   //! Mixed sums and differences convert both operands to the result type first.
+   //! Mixed products and quotients are computed from the raw operands in a double-width integer, with one final rounding,
+   //!    so a product of two quantities keeps as many fractional bits as the more precise of its operands.
+   template<int LB, int LF, int RB, int RF>
+   constexpr common_fixed_t<fixed<LB, LF>, fixed<RB, RF>> operator+(const fixed<LB, LF>& aLeft, const fixed<RB, RF>& aRight) noexcept
+   {
+      using result = common_fixed_t<fixed<LB, LF>, fixed<RB, RF>>;
+      using wide_type = typename result::wide_type;
+      return result::from_raw(static_cast<typename result::raw_type>(
+         static_cast<wide_type>(result(aLeft).raw()) + static_cast<wide_type>(result(aRight).raw())));
+   }
+   template<int LB, int LF, int RB, int RF>
+   constexpr common_fixed_t<fixed<LB, LF>, fixed<RB, RF>> operator-(const fixed<LB, LF>& aLeft, const fixed<RB, RF>& aRight) noexcept
+   {
+      using result = common_fixed_t<fixed<LB, LF>, fixed<RB, RF>>;
+      using wide_type = typename result::wide_type;
+      return result::from_raw(static_cast<typename result::raw_type>(
+         static_cast<wide_type>(result(aLeft).raw()) - static_cast<wide_type>(result(aRight).raw())));
+   }
+   template<int LB, int LF, int RB, int RF>
+   constexpr common_fixed_t<fixed<LB, LF>, fixed<RB, RF>> operator*(const fixed<LB, LF>& aLeft, const fixed<RB, RF>& aRight) noexcept
+   {
+      using result = common_fixed_t<fixed<LB, LF>, fixed<RB, RF>>;
+      using wide_type = typename result::wide_type;
+      // The product has LF + RF fractional bits, of which result::frac_bits are kept.
+      constexpr int shift = LF + RF - result::frac_bits;
+      const wide_type product = static_cast<wide_type>(aLeft.raw()) * static_cast<wide_type>(aRight.raw());
+      if constexpr (shift == 0)
+      {
+         return result::from_raw(static_cast<typename result::raw_type>(product));
+      }
+      else
+      {
+         return result::from_raw(static_cast<typename result::raw_type>(((product >> (shift - 1)) + 1) >> 1));
+      }
+   }
+   template<int LB, int LF, int RB, int RF>
+   constexpr common_fixed_t<fixed<LB, LF>, fixed<RB, RF>> operator/(const fixed<LB, LF>& aLeft, const fixed<RB, RF>& aRight) noexcept
+   {
+      using result = common_fixed_t<fixed<LB, LF>, fixed<RB, RF>>;
+      using wide_type = typename result::wide_type;
+      // Pre-scaling the dividend leaves result::frac_bits fractional bits in the quotient.
+      constexpr int shift = result::frac_bits + RF - LF;
+      return result::from_raw(static_cast<typename result::raw_type>(
+         static_cast<wide_type>(static_cast<wide_type>(aLeft.raw()) * (wide_type(1) << shift)) / static_cast<wide_type>(aRight.raw())));
+   }
+
+   //! Fixed-point types may be used wherever rgf::arithmetic is required.
+   template<int BITS, int FRAC_BITS>
+   constexpr bool enable_arithmetic_v<fixed<BITS, FRAC_BITS>> = true;
+
+   namespace detail
+   {
+      //! fixed_scaler<BITS> multiplies raw BITS-bit fixed-point values by a constant positive factor,
+      //!    with one double-width integer multiplication and a rounding shift.
+      //! The factor is stored as a BITS-bit multiplier with its top bit set and a shift,
+      //!    so it keeps BITS significant bits however large or small it is.
+      //! The factor must be less than 2^(BITS - 1).
+      template<int BITS>
+      class fixed_scaler
+      {
+      public:
+         using raw_type = typename rgf::detail::fixed_integers<BITS>::type;
+         using wide_type = typename rgf::detail::fixed_integers<BITS>::wide_type;
+         using multiplier_type = std::make_unsigned_t<raw_type>;
+
+         constexpr fixed_scaler() noexcept
+            : fixed_scaler(1.0)
+         {}
+
+         constexpr explicit fixed_scaler(double aFactor) noexcept
+         {
+            assert(aFactor > 0);
+            int exponent = 0;
+            while (aFactor >= 2)
+            {
+               aFactor /= 2;
+               ++exponent;
+            }
+            while (aFactor < 1)
+            {
+               aFactor *= 2;
+               --exponent;
+            }
+
+            // aFactor is now in [1, 2), and is scaled to [2^(BITS - 1), 2^BITS), rounding to nearest.
+            const double multiplier = aFactor * rgf::detail::power_of_two<double>(BITS - 1) + 0.5;
+            if (multiplier >= rgf::detail::power_of_two<double>(BITS))
+            {
+               mMultiplier = multiplier_type(1) << (BITS - 1);
+               ++exponent;
+            }
+            else
+            {
+               mMultiplier = static_cast<multiplier_type>(multiplier);
+            }
+            mShift = BITS - 1 - exponent;
+
+            assert(mShift >= 1);
+            if (mShift >= 2 * BITS)
+            {
+               // Every product rounds to zero.
+               mMultiplier = 0;
+               mShift = 1;
+            }
+         }
+
+         constexpr raw_type operator()(raw_type aValue) const noexcept
+         {
+            const wide_type product = static_cast<wide_type>(aValue) * static_cast<wide_type>(mMultiplier);
+            return static_cast<raw_type>(((product >> (mShift - 1)) + 1) >> 1);
+         }
+
+      private:
+         multiplier_type mMultiplier = 0;
+         int mShift = 1;
+      };
+   }
+
+   static_assert(rgf::detail::is_zero_overhead_wrapper_v<quantity<dimension_t<>, fixed<32, 16>>>);
+}
@@ -0,0 +1,115 @@
+#pragma once
+
+#include <cassert>
+#include <concepts>
+#include <cstdint>
+#include <type_traits>
+
+namespace rgf
+{
+   namespace detail
+   {
+      //! Returns the high 64 bits of the 128 bit product aLeft * aRight.
+      constexpr std::uint64_t multiply_high(std::uint64_t aLeft, std::uint64_t aRight) noexcept
+      {
+#if defined(__SIZEOF_INT128__)
+         __extension__ using uint128 = unsigned __int128;
+         return static_cast<std::uint64_t>((static_cast<uint128>(aLeft) * aRight) >> 64);
+#else
+         const std::uint64_t leftLow = aLeft & 0xFFFF'FFFF;
+         const std::uint64_t leftHigh = aLeft >> 32;
+         const std::uint64_t rightLow = aRight & 0xFFFF'FFFF;
+         const std::uint64_t rightHigh = aRight >> 32;
+         const std::uint64_t low = leftLow * rightLow;
+         const std::uint64_t middle1 = leftHigh * rightLow + (low >> 32);
+         const std::uint64_t middle2 = leftLow * rightHigh + (middle1 & 0xFFFF'FFFF);
+         return leftHigh * rightHigh + (middle1 >> 32) + (middle2 >> 32);
+#endif
+      }
+   }
+
+   //! integer_divider<T> divides integers by a divisor that is fixed at runtime, without a hardware division instruction.
+   //! The constructor precomputes a magic multiplier and shift (Granlund & Montgomery, as popularized by libdivide),
+   //!    after which each division is one high multiplication, an add and two shifts.
+   //! Results are identical to the built-in operator/, i.e. truncated towards zero.
+   //! The divisor must be positive.
+   template<std::integral T>
+   class integer_divider
+   {
+   public:
+      using value_type = T;
+
+      constexpr integer_divider() noexcept
+         : integer_divider(1)
+      {}
+
+      constexpr explicit integer_divider(value_type aDivisor) noexcept
+         : mDivisor(aDivisor)
+      {
+         assert(aDivisor > 0);
+         const std::uint64_t divisor = static_cast<std::uint64_t>(aDivisor);
+
+         int log2Divisor = 0;
+         while (log2Divisor < 64 && (std::uint64_t(1) << log2Divisor) < divisor)
+         {
+            ++log2Divisor;
+         }
+
+         // mMagic = floor(2^64 * (2^log2Divisor - divisor) / divisor) + 1, computed by long division.
+         std::uint64_t remainder = (log2Divisor == 64 ? 0 : std::uint64_t(1) << log2Divisor) - divisor;
+         std::uint64_t quotient = 0;
+         for (int bit = 0; bit < 64; ++bit)
+         {
+            const bool carry = (remainder >> 63) != 0;
+            remainder <<= 1;
+            quotient <<= 1;
+            if (carry || remainder >= divisor)
+            {
+               remainder -= divisor;
+               quotient |= 1;
+            }
+         }
+         mMagic = quotient + 1;
+         mShift1 = log2Divisor < 1 ? log2Divisor : 1;
+         mShift2 = log2Divisor > 1 ? log2Divisor - 1 : 0;
+      }
+
+      constexpr value_type divisor() const noexcept
+      {
+         return mDivisor;
+      }
+
+      //! Returns aValue / divisor().
+      constexpr value_type divide(value_type aValue) const noexcept
+      {
+         if constexpr (std::is_signed_v<value_type>)
+         {
+            // Divide the magnitude, then restore the sign without branching.
+            const std::uint64_t sign = aValue < 0 ? ~std::uint64_t(0) : 0;
+            const std::uint64_t magnitude = (static_cast<std::uint64_t>(aValue) ^ sign) - sign;
+            return static_cast<value_type>((divide_unsigned(magnitude) ^ sign) - sign);
+         }
+         else
+         {
+            return static_cast<value_type>(divide_unsigned(aValue));
+         }
+      }
+
+      constexpr friend bool operator==(const integer_divider& aLeft, const integer_divider& aRight) noexcept
+      {
+         return aLeft.mDivisor == aRight.mDivisor;
+      }
+
+   private:
+      constexpr std::uint64_t divide_unsigned(std::uint64_t aValue) const noexcept
+      {
+         const std::uint64_t high = rgf::detail::multiply_high(mMagic, aValue);
+         return (high + ((aValue - high) >> mShift1)) >> mShift2;
+      }
+
+      std::uint64_t mMagic;
+      value_type mDivisor;
+      unsigned char mShift1;
+      unsigned char mShift2;
+   };
+}
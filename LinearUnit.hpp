@@ -1,11 +1,219 @@
 #pragma once
 
+#include "Fixed.hpp"
+#include "IntegerDivider.hpp"
 #include "Quantity.hpp"
+#include "Rational.hpp"
 
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <type_traits>
 #include <utility>
 
 namespace rgf
 {
+   namespace detail
+   {
+      //! Writes aValues[i] * aFactor to aResults[i] for every i.
+      //! aValues and aResults may be the same buffer.
+      //! The loop is kept trivial so that optimizing compilers vectorize it for the target instruction set.
+      template<typename T>
+      constexpr void scale_values(const T* aValues, T* aResults, std::size_t aSize, T aFactor) noexcept
+      {
+         for (std::size_t i = 0; i < aSize; ++i)
+         {
+            aResults[i] = aValues[i] * aFactor;
+         }
+      }
+
+      //! Writes aValues[i] / aDivisor to aResults[i] for every i.
+      //! For floating point types the reciprocal is computed once and each element is multiplied by it,
+      //!    which may differ from a true division by one unit in the last place.
+      template<typename T>
+      constexpr void unscale_values(const T* aValues, T* aResults, std::size_t aSize, T aDivisor) noexcept
+      {
+         if constexpr (std::is_floating_point_v<T>)
+         {
+            rgf::detail::scale_values(aValues, aResults, aSize, T(1) / aDivisor);
+         }
+         else
+         {
+            for (std::size_t i = 0; i < aSize; ++i)
+            {
+               aResults[i] = aValues[i] / aDivisor;
+            }
+         }
+      }
+
+      //! linear_factor<T> stores a linear_unit's conversion factor and applies it in either direction.
+      //! Non-integral value types store the factor as a value_type.
+      template<typename T>
+      class linear_factor
+      {
+      public:
+         using factor_type = T;
+
+         constexpr linear_factor() noexcept = default;
+         constexpr linear_factor(factor_type aFactor) noexcept
+            : mFactor(aFactor)
+         {}
+
+         constexpr factor_type get() const noexcept
+         {
+            return mFactor;
+         }
+
+         constexpr T to_standard_value(T aValue) const noexcept
+         {
+            return aValue * mFactor;
+         }
+         constexpr T from_standard_value(T aValue) const noexcept
+         {
+            return aValue / mFactor;
+         }
+
+         constexpr void to_standard_values(std::span<const T> aValues, std::span<T> aResults) const noexcept
+         {
+            rgf::detail::scale_values(aValues.data(), aResults.data(), aValues.size(), mFactor);
+         }
+         constexpr void from_standard_values(std::span<const T> aValues, std::span<T> aResults) const noexcept
+         {
+            rgf::detail::unscale_values(aValues.data(), aResults.data(), aValues.size(), mFactor);
+         }
+
+      private:
+         factor_type mFactor = factor_type(1);
+      };
+
+      //! Integral value types store the factor as an exact rational.
+      //! Converting multiplies by one side of the fraction and divides by the other through an integer_divider,
+      //!    so no hardware division instruction is executed. Whole-number factors such as kilometers, and their inverses,
+      //!    skip the divider and cost a single multiplication, as with static_linear_unit.
+      template<std::integral T>
+      class linear_factor<T>
+      {
+      public:
+         using factor_type = rgf::rational<T>;
+
+         constexpr linear_factor() noexcept = default;
+         constexpr linear_factor(factor_type aFactor) noexcept
+            : mNumerator(aFactor.num())
+            , mDenominator(aFactor.den())
+         {}
+
+         constexpr factor_type get() const noexcept
+         {
+            return { mNumerator.divisor(), mDenominator.divisor() };
+         }
+
+         constexpr T to_standard_value(T aValue) const noexcept
+         {
+            return scale(aValue, mNumerator, mDenominator);
+         }
+         constexpr T from_standard_value(T aValue) const noexcept
+         {
+            return scale(aValue, mDenominator, mNumerator);
+         }
+
+         constexpr void to_standard_values(std::span<const T> aValues, std::span<T> aResults) const noexcept
+         {
+            scale_values(aValues, aResults, mNumerator, mDenominator);
+         }
+         constexpr void from_standard_values(std::span<const T> aValues, std::span<T> aResults) const noexcept
+         {
+            scale_values(aValues, aResults, mDenominator, mNumerator);
+         }
+
+      private:
+         //! Returns aValue * aMultiplier / aDivider.
+         constexpr static T scale(T aValue, const rgf::integer_divider<T>& aMultiplier, const rgf::integer_divider<T>& aDivider) noexcept
+         {
+            if (aDivider.divisor() == 1)
+            {
+               return static_cast<T>(aValue * aMultiplier.divisor());
+            }
+            return aDivider.divide(static_cast<T>(aValue * aMultiplier.divisor()));
+         }
+
+         //! Batch version of scale. The test for a whole-number factor is made once, outside the loops.
+         constexpr static void scale_values(std::span<const T> aValues, std::span<T> aResults,
+            const rgf::integer_divider<T>& aMultiplier, const rgf::integer_divider<T>& aDivider) noexcept
+         {
+            const T multiplier = aMultiplier.divisor();
+            if (aDivider.divisor() == 1)
+            {
+               for (std::size_t i = 0; i < aValues.size(); ++i)
+               {
+                  aResults[i] = static_cast<T>(aValues[i] * multiplier);
+               }
+            }
+            else
+            {
+               for (std::size_t i = 0; i < aValues.size(); ++i)
+               {
+                  aResults[i] = aDivider.divide(static_cast<T>(aValues[i] * multiplier));
+               }
+            }
+         }
+
+         rgf::integer_divider<T> mNumerator;
+         rgf::integer_divider<T> mDenominator;
+      };
+
+      //! Fixed-point value types store the factor as a double, and precompute a fixed_scaler for each direction,
+      //!    so converting is an integer multiplication and shift either way, with no division or floating point.
+      template<int BITS, int FRAC_BITS>
+      class linear_factor<rgf::fixed<BITS, FRAC_BITS>>
+      {
+      public:
+         using value_type = rgf::fixed<BITS, FRAC_BITS>;
+         using factor_type = double;
+
+         constexpr linear_factor() noexcept = default;
+         constexpr linear_factor(factor_type aFactor) noexcept
+            : mFactor(aFactor)
+            , mToStandard(aFactor)
+            , mFromStandard(1 / aFactor)
+         {}
+
+         constexpr factor_type get() const noexcept
+         {
+            return mFactor;
+         }
+
+         constexpr value_type to_standard_value(value_type aValue) const noexcept
+         {
+            return value_type::from_raw(mToStandard(aValue.raw()));
+         }
+         constexpr value_type from_standard_value(value_type aValue) const noexcept
+         {
+            return value_type::from_raw(mFromStandard(aValue.raw()));
+         }
+
+         constexpr void to_standard_values(std::span<const value_type> aValues, std::span<value_type> aResults) const noexcept
+         {
+            for (std::size_t i = 0; i < aValues.size(); ++i)
+            {
+               aResults[i] = to_standard_value(aValues[i]);
+            }
+         }
+         constexpr void from_standard_values(std::span<const value_type> aValues, std::span<value_type> aResults) const noexcept
+         {
+            for (std::size_t i = 0; i < aValues.size(); ++i)
+            {
+               aResults[i] = from_standard_value(aValues[i]);
+            }
+         }
+
+      private:
+         factor_type mFactor = 1;
+         rgf::detail::fixed_scaler<BITS> mToStandard;
+         rgf::detail::fixed_scaler<BITS> mFromStandard;
+      };
+   }
+
    //! linear_unit is a unit that may be linearly multiplied and divided by other linear units.
    //! This encompasses most units common in everyday use, except for Fahrenheit, Celcius, and decibels.
    //! For these other units, specialized classes should be written that provides, at a minimum, from_standard_value(quantity_type).
@@ -19,16 +227,21 @@ namespace rgf
 
       using quantity_type = quantity<dimension, value_type>;
 
+      //! The type of the conversion factor.
+      //! This is value_type, except for integral value types, where it is the exact rgf::rational<value_type>,
+      //!    and fixed-point value types, where it is double.
+      using factor_type = typename rgf::detail::linear_factor<value_type>::factor_type;
+
       constexpr explicit linear_unit() noexcept = default;
 
-      constexpr linear_unit(std::in_place_t, value_type aConversionFactor) noexcept
+      constexpr linear_unit(std::in_place_t, factor_type aConversionFactor) noexcept
          : mConversionFactor(aConversionFactor)
       {}
 
       //! Returns the unit's conversion factor stored under the hood.
-      constexpr value_type conversion_factor() const noexcept
+      constexpr factor_type conversion_factor() const noexcept
       {
-         return mConversionFactor;
+         return mConversionFactor.get();
       }
 
       //! The call operator converts a value to a quantity with that value.
@@ -39,12 +252,12 @@ namespace rgf
       }
       constexpr value_type to_standard_value(value_type aValue) const noexcept
       {
-         return aValue * mConversionFactor;
+         return mConversionFactor.to_standard_value(aValue);
       }
       //! Converts from standard units into *this's unit.
       constexpr value_type from_standard_value(value_type aValue) const noexcept
       {
-         return aValue / mConversionFactor;
+         return mConversionFactor.from_standard_value(aValue);
       }
       //! Converts a quantity from standard units into *this's unit.
       constexpr value_type get(quantity_type aQuantity) const noexcept
@@ -52,18 +265,53 @@ namespace rgf
          return from_standard_value(aQuantity.get_standard());
       }
 
+      //! Batch versions of to_standard_value.
+      //! Overload 1 converts aValues in place.
+      //! Overload 2 writes the converted values to aResults, which must be at least as large as aValues.
+      constexpr void to_standard_values(std::span<value_type> aValues) const noexcept
+      {
+         mConversionFactor.to_standard_values(aValues, aValues);
+      }
+      constexpr void to_standard_values(std::span<const value_type> aValues, std::span<value_type> aResults) const noexcept
+      {
+         assert(aResults.size() >= aValues.size());
+         mConversionFactor.to_standard_values(aValues, aResults);
+      }
+
+      //! Batch versions of from_standard_value.
+      //! Overload 1 converts aValues in place.
+      //! Overload 2 writes the converted values to aResults, which must be at least as large as aValues.
+      //! For floating point types, each value is multiplied by the reciprocal of the conversion factor.
+      constexpr void from_standard_values(std::span<value_type> aValues) const noexcept
+      {
+         mConversionFactor.from_standard_values(aValues, aValues);
+      }
+      constexpr void from_standard_values(std::span<const value_type> aValues, std::span<value_type> aResults) const noexcept
+      {
+         assert(aResults.size() >= aValues.size());
+         mConversionFactor.from_standard_values(aValues, aResults);
+      }
+
       //! Creates a new linear_unit scaled up in size.
       //! E.g. inline constexpr auto kilometers = meters.scaled_up(1000);
-      constexpr linear_unit scaled_up(value_type aFactor) const noexcept
+      //! Units with an integral value_type are scaled exactly, and may be scaled by a rational.
+      //! Scaling them by a floating point factor is ill-formed rather than silently truncating.
+      constexpr linear_unit scaled_up(factor_type aFactor) const noexcept
       {
-         return linear_unit(std::in_place, mConversionFactor * aFactor);
+         return linear_unit(std::in_place, conversion_factor() * aFactor);
       }
+      template<std::floating_point T>
+      constexpr linear_unit scaled_up(T aFactor) const noexcept requires std::integral<value_type> = delete;
+
       //! Creates a new linear_unit scaled down in size.
       //! E.g. inline constexpr auto millimeters = meters.scaled_down(1000);
-      constexpr linear_unit scaled_down(value_type aFactor) const noexcept
+      //! The same rules as scaled_up apply to units with an integral value_type.
+      constexpr linear_unit scaled_down(factor_type aFactor) const noexcept
       {
-         return linear_unit(std::in_place, mConversionFactor / aFactor);
+         return linear_unit(std::in_place, conversion_factor() / aFactor);
       }
+      template<std::floating_point T>
+      constexpr linear_unit scaled_down(T aFactor) const noexcept requires std::integral<value_type> = delete;
 
       //! Multiplies two linear_units together.
       //! They must have the same value_type, but can have different dimensions.
@@ -89,6 +337,10 @@ namespace rgf
       }
 
    private:
-      value_type mConversionFactor = 1;
+      rgf::detail::linear_factor<value_type> mConversionFactor;
    };
+
+   //! Floating point units must stay as cheap to pass around as their factor.
+   static_assert(rgf::detail::is_zero_overhead_wrapper_v<linear_unit<dimension_t<>, float>>);
+   static_assert(rgf::detail::is_zero_overhead_wrapper_v<linear_unit<dimension_t<>, double>>);
 }
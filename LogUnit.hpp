@@ -0,0 +1,436 @@
+#pragma once
+
+#include "AffineUnit.hpp"
+#include "Dimension.hpp"
+#include "Quantity.hpp"
+
+#include <array>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <numbers>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace rgf
+{
+   //! Accuracy of log_unit conversions between levels and standard values.
+   //!    exact  Uses std::log and std::exp, which are typically within one unit in the last place.
+   //!    fast   Uses polynomial approximations written so that compilers vectorize batch conversions. For float and double,
+   //!           the natural logarithm is within 3 units in the last place and the exponential within 2, for normal inputs and results.
+   //!           Zero, negative, infinite and NaN inputs give the same results as the exact versions. Subnormal inputs give
+   //!           unspecified results, and results beyond the normal range become zero or infinity.
+   //!           The fast versions only pay off when vectorized, e.g. at -O3. Scalar code, such as GCC 12 generates at -O2,
+   //!           is slower than the standard library.
+   enum class log_precision
+   {
+      exact,
+      fast
+   };
+
+   namespace detail
+   {
+      //! Bit layout and polynomial lengths of the fast logarithm and exponential for float and double.
+      template<std::floating_point T>
+      struct fast_log_traits;
+      template<>
+      struct fast_log_traits<float>
+      {
+         using bits_type = std::uint32_t;
+         constexpr static int log_terms = 5;
+         constexpr static int exp_degree = 7;
+         //! ln(2) split so that multiplying the high part by an exponent is exact.
+         constexpr static float ln2_high = 6.9313812256e-01f;
+         constexpr static float ln2_low = 9.0580006145e-06f;
+      };
+      template<>
+      struct fast_log_traits<double>
+      {
+         using bits_type = std::uint64_t;
+         constexpr static int log_terms = 10;
+         constexpr static int exp_degree = 13;
+         constexpr static double ln2_high = 6.93147180369123816490e-01;
+         constexpr static double ln2_low = 1.90821492927058770002e-10;
+      };
+
+      //! Coefficients 2 / (2k + 1) of ln(m) = 2 atanh(s) = 2 (s + s^3 / 3 + s^5 / 5 + ...), where s = (m - 1) / (m + 1).
+      template<std::floating_point T>
+      constexpr auto fast_log_coefficients = []
+      {
+         std::array<T, fast_log_traits<T>::log_terms> coefficients{};
+         for (std::size_t k = 0; k < coefficients.size(); ++k)
+         {
+            coefficients[k] = static_cast<T>(2.0 / static_cast<double>(2 * k + 1));
+         }
+         return coefficients;
+      }();
+
+      //! Coefficients 1 / k! of the Taylor series of exp(r).
+      template<std::floating_point T>
+      constexpr auto fast_exp_coefficients = []
+      {
+         std::array<T, fast_log_traits<T>::exp_degree + 1> coefficients{};
+         double factorial = 1;
+         for (std::size_t k = 0; k < coefficients.size(); ++k)
+         {
+            factorial *= k > 0 ? static_cast<double>(k) : 1.0;
+            coefficients[k] = static_cast<T>(1 / factorial);
+         }
+         return coefficients;
+      }();
+
+      //! Returns the natural logarithm of aValue, see log_precision::fast.
+      //! aValue is split into m * 2^k, with m in [sqrt(1/2), sqrt(2)), using integer operations only, so that the function
+      //!    vectorizes even where the instruction set has no 64-bit arithmetic shift or integer to floating point conversion.
+      //! Special values are handled by adjusting k, rather than by replacing the result. Compilers would otherwise only compute
+      //!    the polynomial for ordinary values, and do not vectorize floating point operations that are conditional.
+      template<std::floating_point T>
+      constexpr T fast_log(T aValue) noexcept
+      {
+         using traits = fast_log_traits<T>;
+         using bits_type = typename traits::bits_type;
+         using limits = std::numeric_limits<T>;
+         constexpr int mantissa_bits = limits::digits - 1;
+         constexpr bits_type bias = limits::max_exponent - 1;
+         constexpr bits_type exponent_mask = ~bits_type(0) << mantissa_bits;
+         // The bits of sqrt(1/2). Subtracting them, and adding the bias, makes the exponent field k + bias.
+         constexpr bits_type sqrt_half = std::bit_cast<bits_type>(static_cast<T>(0.70710678118654752440));
+
+         const bits_type bits = std::bit_cast<bits_type>(aValue);
+         const bits_type shifted = bits - sqrt_half + (bias << mantissa_bits);
+         const T m = std::bit_cast<T>(bits - (shifted & exponent_mask) + (bias << mantissa_bits));
+
+         // Converts k + bias to floating point by placing it in the mantissa of 2^mantissa_bits.
+         constexpr bits_type magic = std::bit_cast<bits_type>(static_cast<T>(bits_type(1) << mantissa_bits));
+         const T ordinaryK = std::bit_cast<T>(magic | (shifted >> mantissa_bits)) - static_cast<T>((bits_type(1) << mantissa_bits) + bias);
+
+         // Special values make k infinite or NaN by adding an infinity or NaN to it.
+         T special = 0;
+         special = aValue >= 0 ? special : limits::quiet_NaN();
+         special = aValue == limits::infinity() ? limits::infinity() : special;
+         special = aValue == 0 ? -limits::infinity() : special;
+         const T k = ordinaryK + special;
+
+         const T s = (m - 1) / (m + 1);
+         const T z = s * s;
+         const auto& coefficients = fast_log_coefficients<T>;
+         T polynomial = coefficients.back();
+         for (std::size_t i = coefficients.size() - 1; i-- > 0;)
+         {
+            polynomial = polynomial * z + coefficients[i];
+         }
+         return k * traits::ln2_high + (s * polynomial + k * traits::ln2_low);
+      }
+
+      //! Returns e^aValue, see log_precision::fast.
+      //! aValue is split into n ln(2) + r, with |r| <= ln(2) / 2, and 2^n is built directly from its bits.
+      //! As in fast_log, results out of range are handled by replacing 2^n, rather than the result.
+      template<std::floating_point T>
+      constexpr T fast_exp(T aValue) noexcept
+      {
+         using traits = fast_log_traits<T>;
+         using bits_type = typename traits::bits_type;
+         using limits = std::numeric_limits<T>;
+         constexpr int mantissa_bits = limits::digits - 1;
+         constexpr bits_type bias = limits::max_exponent - 1;
+         constexpr T lowest = (limits::min_exponent - 1) * std::numbers::ln2_v<T>;
+         constexpr T highest = (limits::max_exponent - 1) * std::numbers::ln2_v<T>;
+         // Adding 1.5 * 2^mantissa_bits rounds to an integer n, and leaves n in the low bits.
+         constexpr T shifter = static_cast<T>(3 * (bits_type(1) << (mantissa_bits - 1)));
+
+         // Infinite inputs are clamped, since the reduction would otherwise compute inf - inf. The selects below still see
+         //    aValue, and give zero and infinity.
+         const T clamped = aValue < lowest ? lowest : (aValue > highest ? highest : aValue);
+         const T shiftedN = clamped * std::numbers::log2e_v<T> + shifter;
+         const T n = shiftedN - shifter;
+         const T r = (clamped - n * traits::ln2_high) - n * traits::ln2_low;
+
+         bits_type scaleBits = (std::bit_cast<bits_type>(shiftedN) + bias) << mantissa_bits;
+         // NaN fails both comparisons, and propagates through the polynomial.
+         scaleBits = aValue < lowest ? 0 : scaleBits;
+         scaleBits = aValue > highest ? std::bit_cast<bits_type>(limits::infinity()) : scaleBits;
+
+         const auto& coefficients = fast_exp_coefficients<T>;
+         T polynomial = coefficients.back();
+         for (std::size_t i = coefficients.size() - 1; i-- > 0;)
+         {
+            polynomial = polynomial * r + coefficients[i];
+         }
+         return polynomial * std::bit_cast<T>(scaleBits);
+      }
+
+      //! Writes (ln(aValues[i]) - aLogReference) * aScale to aResults[i] for every i.
+      template<std::floating_point T>
+      void log_values(const T* aValues, T* aResults, std::size_t aSize, T aScale, T aLogReference, log_precision aPrecision) noexcept
+      {
+         if (aPrecision == log_precision::fast)
+         {
+            for (std::size_t i = 0; i < aSize; ++i)
+            {
+               aResults[i] = (rgf::detail::fast_log(aValues[i]) - aLogReference) * aScale;
+            }
+         }
+         else
+         {
+            for (std::size_t i = 0; i < aSize; ++i)
+            {
+               aResults[i] = (std::log(aValues[i]) - aLogReference) * aScale;
+            }
+         }
+      }
+
+      //! Writes e^(aValues[i] * aScale + aLogReference) to aResults[i] for every i.
+      template<std::floating_point T>
+      void exp_values(const T* aValues, T* aResults, std::size_t aSize, T aScale, T aLogReference, log_precision aPrecision) noexcept
+      {
+         if (aPrecision == log_precision::fast)
+         {
+            for (std::size_t i = 0; i < aSize; ++i)
+            {
+               aResults[i] = rgf::detail::fast_exp(rgf::detail::multiply_add(aValues[i], aScale, aLogReference));
+            }
+         }
+         else
+         {
+            for (std::size_t i = 0; i < aSize; ++i)
+            {
+               aResults[i] = std::exp(rgf::detail::multiply_add(aValues[i], aScale, aLogReference));
+            }
+         }
+      }
+   }
+
+   //! log_quantity<DIMENSION, VALUE_TYPE> represents a quantity by the natural logarithm of its value in standard units,
+   //!    such as a power level in dBm, or a gain in dB.
+   //! Arithmetic follows the linear values: adding log_quantities multiplies the values, so their dimensions multiply,
+   //!    and subtracting them divides. E.g. a power level plus a gain is a power level, and the difference of
+   //!    two power levels is a scalar ratio.
+   //! Use to_quantity and to_log_quantity to convert to and from linear quantities.
+   template<dimension_type LOG_DIMENSION, std::floating_point LOG_VALUE_TYPE = double>
+   class log_quantity
+   {
+   public:
+      using dimension = LOG_DIMENSION;
+      using value_type = LOG_VALUE_TYPE;
+
+      using quantity_type = quantity<dimension, value_type>;
+      using scalar_log_quantity_type = log_quantity<dimension_quotient_t<dimension, dimension>, value_type>;
+
+      constexpr static bool is_scalar = rgf::empty_dimension<dimension>;
+
+      //! When default-constructed, the logarithm is zero, so the linear value is one in standard units.
+      constexpr log_quantity() = default;
+      constexpr log_quantity(const log_quantity&) = default;
+
+      //! Constructor for setting the natural logarithm of the value in standard units.
+      constexpr log_quantity(std::in_place_t, value_type aStandardLog) noexcept
+         : mStandardLog(aStandardLog)
+      {}
+
+      constexpr log_quantity& operator=(const log_quantity&) = default;
+
+      //! Accessor for the natural logarithm of the value in standard units.
+      //! Generally not necessary. Use other APIs when possible.
+      constexpr value_type get_standard() const noexcept
+      {
+         return mStandardLog;
+      }
+      //! Mutator for the natural logarithm of the value in standard units.
+      //! Generally not necessary. Use other APIs when possible.
+      constexpr void set_standard_value(value_type aValue) noexcept
+      {
+         mStandardLog = aValue;
+      }
+
+      template<unit_type<log_quantity> UNIT>
+      constexpr auto get(const UNIT& aUnit) const
+      {
+         return aUnit.get(*this);
+      }
+
+      //! In-place addition and subtraction of scalar log_quantities, such as gains and losses in dB.
+      constexpr log_quantity& operator+=(const scalar_log_quantity_type& aOther) noexcept
+      {
+         mStandardLog += aOther.get_standard();
+         return *this;
+      }
+      constexpr log_quantity& operator-=(const scalar_log_quantity_type& aOther) noexcept
+      {
+         mStandardLog -= aOther.get_standard();
+         return *this;
+      }
+
+      //! Adding log_quantities multiplies their linear values.
+      template<dimension_type RDIM>
+      constexpr friend log_quantity<dimension_product_t<dimension, RDIM>, value_type>
+         operator+(const log_quantity& aLeft, const log_quantity<RDIM, value_type>& aRight) noexcept
+      {
+         return { std::in_place, aLeft.get_standard() + aRight.get_standard() };
+      }
+      //! Subtracting log_quantities divides their linear values.
+      template<dimension_type RDIM>
+      constexpr friend log_quantity<dimension_quotient_t<dimension, RDIM>, value_type>
+         operator-(const log_quantity& aLeft, const log_quantity<RDIM, value_type>& aRight) noexcept
+      {
+         return { std::in_place, aLeft.get_standard() - aRight.get_standard() };
+      }
+
+      //! Multiplying a scalar log_quantity raises its linear value to a power, e.g. 3dB * 2 is 6dB.
+      constexpr friend log_quantity operator*(const log_quantity& aLeft, value_type aRight) noexcept requires is_scalar
+      {
+         return { std::in_place, aLeft.get_standard() * aRight };
+      }
+      constexpr friend log_quantity operator*(value_type aLeft, const log_quantity& aRight) noexcept requires is_scalar
+      {
+         return { std::in_place, aLeft * aRight.get_standard() };
+      }
+      //! Negating a scalar log_quantity inverts its linear value, e.g. a gain into a loss.
+      constexpr log_quantity operator-() const noexcept requires is_scalar
+      {
+         return { std::in_place, -mStandardLog };
+      }
+
+      //! Comparison operators. The logarithm is monotonic, so they order the linear values.
+      constexpr friend bool operator==(const log_quantity& aLeft, const log_quantity& aRight) noexcept = default;
+      constexpr friend auto operator<=>(const log_quantity& aLeft, const log_quantity& aRight) noexcept = default;
+
+   private:
+      value_type mStandardLog = value_type();
+   };
+
+   //! log_unit is a logarithmic unit, whose level L for a value x in standard units is
+   //!    L = levels_per_decade * log10(x / reference).
+   //! E.g. dBm has 10 levels per decade and a reference of one milliwatt, so one watt is 30dBm.
+   //! Levels of scalar log_units are power ratios, so decibels have 10 levels per decade and nepers ln(10) / 2.
+   //! The call operator and get(log_quantity) convert between levels and log_quantity with one multiply-add, and are the
+   //!    preferred way to do arithmetic on levels. Converting to and from linear values costs a logarithm or exponential,
+   //!    and may be done with either log_precision.
+   template<rgf::dimension_type UNIT_DIMENSION, std::floating_point UNIT_VALUE_TYPE = double>
+   class log_unit
+   {
+   public:
+      using dimension = UNIT_DIMENSION;
+      using value_type = UNIT_VALUE_TYPE;
+
+      using quantity_type = quantity<dimension, value_type>;
+      using log_quantity_type = log_quantity<dimension, value_type>;
+
+      //! aReference is in standard units, and must be positive. Its logarithm is taken with std::log, so it is exact for
+      //!    both precisions, but this constructor is not usable in constant expressions. See from_log_reference.
+      log_unit(std::in_place_t, value_type aLevelsPerDecade, value_type aReference) noexcept
+         : log_unit(aLevelsPerDecade, std::log(aReference))
+      {
+         assert(aReference > 0);
+      }
+
+      //! Returns the log_unit whose reference in standard units has natural logarithm aLogReference.
+      //! Constant units pass the logarithm as a literal, e.g. 0 for a reference of one standard unit.
+      constexpr static log_unit from_log_reference(value_type aLevelsPerDecade, value_type aLogReference) noexcept
+      {
+         return log_unit(aLevelsPerDecade, aLogReference);
+      }
+
+      //! Returns the number of levels per unit of natural logarithm, e.g. 10 / ln(10) for decibels.
+      constexpr value_type scale() const noexcept
+      {
+         return mScale;
+      }
+      //! Returns the natural logarithm of the reference in standard units.
+      constexpr value_type log_reference() const noexcept
+      {
+         return mLogReference;
+      }
+
+      //! The call operator converts a level to a log_quantity.
+      //! E.g. dBm(30) is the log_quantity of one watt.
+      constexpr log_quantity_type operator()(value_type aLevel) const noexcept
+      {
+         return { std::in_place, rgf::detail::multiply_add(aLevel, mInverseScale, mLogReference) };
+      }
+      //! Converts a log_quantity into a level in *this's unit.
+      constexpr value_type get(log_quantity_type aLogQuantity) const noexcept
+      {
+         return (aLogQuantity.get_standard() - mLogReference) * mScale;
+      }
+      //! Converts a linear quantity into a level in *this's unit.
+      value_type get(quantity_type aQuantity) const noexcept
+      {
+         return from_standard_value(aQuantity.get_standard());
+      }
+
+      //! Converts a level into a linear value in standard units.
+      value_type to_standard_value(value_type aLevel, log_precision aPrecision = log_precision::exact) const noexcept
+      {
+         const value_type standardLog = rgf::detail::multiply_add(aLevel, mInverseScale, mLogReference);
+         return aPrecision == log_precision::fast ? rgf::detail::fast_exp(standardLog) : std::exp(standardLog);
+      }
+      //! Converts a linear value in standard units into a level in *this's unit.
+      value_type from_standard_value(value_type aValue, log_precision aPrecision = log_precision::exact) const noexcept
+      {
+         const value_type standardLog = aPrecision == log_precision::fast ? rgf::detail::fast_log(aValue) : std::log(aValue);
+         return (standardLog - mLogReference) * mScale;
+      }
+
+      //! Batch versions of to_standard_value.
+      //! Overload 1 converts aLevels in place.
+      //! Overload 2 writes the converted values to aResults, which must be at least as large as aLevels.
+      void to_standard_values(std::span<value_type> aLevels, log_precision aPrecision = log_precision::exact) const noexcept
+      {
+         rgf::detail::exp_values(aLevels.data(), aLevels.data(), aLevels.size(), mInverseScale, mLogReference, aPrecision);
+      }
+      void to_standard_values(std::span<const value_type> aLevels, std::span<value_type> aResults,
+         log_precision aPrecision = log_precision::exact) const noexcept
+      {
+         assert(aResults.size() >= aLevels.size());
+         rgf::detail::exp_values(aLevels.data(), aResults.data(), aLevels.size(), mInverseScale, mLogReference, aPrecision);
+      }
+
+      //! Batch versions of from_standard_value.
+      //! Overload 1 converts aValues in place.
+      //! Overload 2 writes the converted levels to aResults, which must be at least as large as aValues.
+      void from_standard_values(std::span<value_type> aValues, log_precision aPrecision = log_precision::exact) const noexcept
+      {
+         rgf::detail::log_values(aValues.data(), aValues.data(), aValues.size(), mScale, mLogReference, aPrecision);
+      }
+      void from_standard_values(std::span<const value_type> aValues, std::span<value_type> aResults,
+         log_precision aPrecision = log_precision::exact) const noexcept
+      {
+         assert(aResults.size() >= aValues.size());
+         rgf::detail::log_values(aValues.data(), aResults.data(), aValues.size(), mScale, mLogReference, aPrecision);
+      }
+
+   private:
+      constexpr log_unit(value_type aLevelsPerDecade, value_type aLogReference) noexcept
+         : mScale(aLevelsPerDecade / std::numbers::ln10_v<value_type>)
+         , mInverseScale(std::numbers::ln10_v<value_type> / aLevelsPerDecade)
+         , mLogReference(aLogReference)
+      {}
+
+      value_type mScale;
+      value_type mInverseScale;
+      value_type mLogReference;
+   };
+
+   //! Converts a linear quantity into a log_quantity. The value must be positive.
+   template<dimension_type DIMENSION, std::floating_point VALUE_TYPE>
+   log_quantity<DIMENSION, VALUE_TYPE> to_log_quantity(const quantity<DIMENSION, VALUE_TYPE>& aQuantity) noexcept
+   {
+      return { std::in_place, std::log(aQuantity.get_standard()) };
+   }
+
+   //! Converts a log_quantity into a linear quantity.
+   template<dimension_type DIMENSION, std::floating_point VALUE_TYPE>
+   quantity<DIMENSION, VALUE_TYPE> to_quantity(const log_quantity<DIMENSION, VALUE_TYPE>& aLogQuantity) noexcept
+   {
+      return { std::in_place, std::exp(aLogQuantity.get_standard()) };
+   }
+
+   static_assert(rgf::detail::is_zero_overhead_wrapper_v<log_quantity<dimension_t<>, float>>);
+   static_assert(rgf::detail::is_zero_overhead_wrapper_v<log_quantity<dimension_t<>, double>>);
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include "Reduce.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#if __has_include(<execution>)
+#include <execution>
+#endif
+
+//! Overloads of the reductions in Reduce.hpp that take a standard execution policy as their first argument.
+//! The range is split into fixed-size chunks that are reduced in parallel, and the partial results are combined in order,
+//!    so the result does not depend on the number of threads.
+//! This header is separate because with libstdc++, <execution> requires linking against TBB when its headers are
+//!    installed, even if no parallel policy is used.
+namespace rgf
+{
+   namespace detail
+   {
+#if defined(__cpp_lib_execution)
+      template<typename POLICY>
+      concept execution_policy = std::is_execution_policy_v<std::remove_cvref_t<POLICY>>;
+#else
+      template<typename POLICY>
+      concept execution_policy = false;
+#endif
+
+      //! Elements per task when reducing with an execution policy.
+      inline constexpr std::size_t parallel_chunk_size = std::size_t(1) << 16;
+
+      //! Calls aReduceChunk(aFirst, aLast) on consecutive chunks of [0, aSize) in parallel under aPolicy,
+      //!    and returns the results in order.
+      template<typename RESULT, typename POLICY, typename REDUCE_CHUNK>
+      std::vector<RESULT> reduce_chunks(POLICY&& aPolicy, std::size_t aSize, REDUCE_CHUNK aReduceChunk)
+      {
+         std::vector<RESULT> partials((aSize + parallel_chunk_size - 1) / parallel_chunk_size);
+         std::for_each(std::forward<POLICY>(aPolicy), partials.begin(), partials.end(), [&](RESULT& aPartial)
+         {
+            const std::size_t first = static_cast<std::size_t>(&aPartial - partials.data()) * parallel_chunk_size;
+            aPartial = aReduceChunk(first, std::min(first + parallel_chunk_size, aSize));
+         });
+         return partials;
+      }
+
+      template<typename T, typename POLICY, typename LOAD>
+      compensated_sum<T> parallel_sum(POLICY&& aPolicy, std::size_t aSize, LOAD aLoad, summation aSummation)
+      {
+         const auto partials = reduce_chunks<compensated_sum<T>>(std::forward<POLICY>(aPolicy), aSize,
+            [&aLoad, aSummation](std::size_t aFirst, std::size_t aLast) { return sum_range<T>(aFirst, aLast, aLoad, aSummation); });
+         compensated_sum<T> result;
+         for (const compensated_sum<T>& partial : partials)
+         {
+            result.add(partial);
+         }
+         return result;
+      }
+
+      template<bool MAX, typename T, typename POLICY, typename LOAD>
+      T parallel_extremum(POLICY&& aPolicy, std::size_t aSize, LOAD aLoad)
+      {
+         const auto partials = reduce_chunks<T>(std::forward<POLICY>(aPolicy), aSize,
+            [&aLoad](std::size_t aFirst, std::size_t aLast) { return extremum_range<MAX, T>(aFirst, aLast, aLoad); });
+         T result = partials.front();
+         for (const T partial : partials)
+         {
+            result = select_extremum<MAX>(result, partial);
+         }
+         return result;
+      }
+   }
+
+   //! rgf::sum of aValues, reduced in parallel under aPolicy.
+   template<rgf::detail::execution_policy POLICY, contiguous_quantity_range RANGE>
+   auto sum(POLICY&& aPolicy, const RANGE& aValues, summation aSummation = summation::pairwise)
+   {
+      using value_type = rgf::detail::range_value_t<RANGE>;
+      const auto values = rgf::detail::range_values(aValues);
+      return quantity<rgf::detail::range_dimension_t<RANGE>, value_type>(std::in_place,
+         rgf::detail::parallel_sum<value_type>(std::forward<POLICY>(aPolicy), values.size(),
+            [values](std::size_t aIndex) { return values[aIndex]; }, aSummation).value());
+   }
+
+   //! rgf::mean of aValues, which must not be empty, reduced in parallel under aPolicy.
+   template<rgf::detail::execution_policy POLICY, contiguous_quantity_range RANGE>
+   auto mean(POLICY&& aPolicy, const RANGE& aValues, summation aSummation = summation::pairwise)
+   {
+      assert(aValues.size() > 0);
+      return rgf::sum(std::forward<POLICY>(aPolicy), aValues, aSummation) / static_cast<rgf::detail::range_value_t<RANGE>>(aValues.size());
+   }
+
+   //! rgf::min of aValues, which must not be empty, reduced in parallel under aPolicy.
+   template<rgf::detail::execution_policy POLICY, contiguous_quantity_range RANGE>
+   auto min(POLICY&& aPolicy, const RANGE& aValues)
+   {
+      assert(aValues.size() > 0);
+      using value_type = rgf::detail::range_value_t<RANGE>;
+      const auto values = rgf::detail::range_values(aValues);
+      return quantity<rgf::detail::range_dimension_t<RANGE>, value_type>(std::in_place,
+         rgf::detail::parallel_extremum<false, value_type>(std::forward<POLICY>(aPolicy), values.size(),
+            [values](std::size_t aIndex) { return values[aIndex]; }));
+   }
+
+   //! rgf::max of aValues, which must not be empty, reduced in parallel under aPolicy.
+   template<rgf::detail::execution_policy POLICY, contiguous_quantity_range RANGE>
+   auto max(POLICY&& aPolicy, const RANGE& aValues)
+   {
+      assert(aValues.size() > 0);
+      using value_type = rgf::detail::range_value_t<RANGE>;
+      const auto values = rgf::detail::range_values(aValues);
+      return quantity<rgf::detail::range_dimension_t<RANGE>, value_type>(std::in_place,
+         rgf::detail::parallel_extremum<true, value_type>(std::forward<POLICY>(aPolicy), values.size(),
+            [values](std::size_t aIndex) { return values[aIndex]; }));
+   }
+
+   //! rgf::dot of aLeft and aRight, which must have the same size, reduced in parallel under aPolicy.
+   template<rgf::detail::execution_policy POLICY, contiguous_quantity_range LEFT_RANGE, contiguous_quantity_range RIGHT_RANGE>
+   auto dot(POLICY&& aPolicy, const LEFT_RANGE& aLeft, const RIGHT_RANGE& aRight, summation aSummation = summation::pairwise)
+   {
+      assert(aLeft.size() == aRight.size());
+      using value_type = std::common_type_t<rgf::detail::range_value_t<LEFT_RANGE>, rgf::detail::range_value_t<RIGHT_RANGE>>;
+      using dimension = dimension_product_t<rgf::detail::range_dimension_t<LEFT_RANGE>, rgf::detail::range_dimension_t<RIGHT_RANGE>>;
+      const auto left = rgf::detail::range_values(aLeft);
+      const auto right = rgf::detail::range_values(aRight);
+      return quantity<dimension, value_type>(std::in_place, rgf::detail::parallel_sum<value_type>(std::forward<POLICY>(aPolicy), left.size(),
+         [left, right](std::size_t aIndex) { return static_cast<value_type>(left[aIndex]) * static_cast<value_type>(right[aIndex]); },
+         aSummation).value());
+   }
+
+   //! rgf::sum_of_squares of aValues, reduced in parallel under aPolicy.
+   template<rgf::detail::execution_policy POLICY, contiguous_quantity_range RANGE>
+   auto sum_of_squares(POLICY&& aPolicy, const RANGE& aValues, summation aSummation = summation::pairwise)
+   {
+      return rgf::dot(std::forward<POLICY>(aPolicy), aValues, aValues, aSummation);
+   }
+}
@@ -2,12 +2,32 @@
 
 #include "Dimension.hpp"
 
+#include <compare>
+#include <concepts>
 #include <utility>
 
 namespace rgf
 {
+   //! Boolean constant that may be specialized to true for class types that behave like built-in arithmetic types,
+   //!    so that they can be used as the value_type of quantities and units, e.g. rgf::fixed.
    template<typename T>
-   concept arithmetic = std::is_arithmetic_v<T>;
+   constexpr bool enable_arithmetic_v = false;
+
+   template<typename T>
+   concept arithmetic = std::is_arithmetic_v<T> || enable_arithmetic_v<T>;
+
+   namespace detail
+   {
+      //! Boolean constant indicating that a wrapper type compiles to exactly the same code as its value_type.
+      //! The wrapper must be trivially copyable, so it is passed in registers and copied with plain moves,
+      //!    and must have the same size and alignment as value_type, so arrays of it vectorize like arrays of value_type.
+      //! Every class that stores a value_type in standard units is checked against this at the end of its header.
+      template<typename T>
+      constexpr bool is_zero_overhead_wrapper_v = std::is_trivially_copyable_v<T>
+         && std::is_standard_layout_v<T>
+         && sizeof(T) == sizeof(typename T::value_type)
+         && alignof(T) == alignof(typename T::value_type);
+   }
 
    
    template<typename L, typename R>
@@ -242,22 +262,71 @@ namespace rgf
 
       //! Comparison operators.
       template<arithmetic T>
+         requires std::three_way_comparable_with<value_type, T>
       constexpr friend auto operator<=>(const quantity& aLeft, const quantity<dimension, T>& aRight) noexcept
       {
          return aLeft.get_standard() <=> aRight.get_standard();
       }
       template<arithmetic T>
+         requires std::three_way_comparable_with<value_type, T>
       constexpr friend auto operator<=>(const quantity& aLeft, T aRight) noexcept requires is_scalar
       {
          return aLeft.get_standard() <=> aRight;
       }
       template<arithmetic T>
+         requires std::three_way_comparable_with<T, value_type>
       constexpr friend auto operator<=>(T aLeft, const quantity& aRight) noexcept requires is_scalar
       {
          return aLeft <=> aRight.get_standard();
       }
 
+      //! Relational and equality operators, which compare the standard values directly rather than through operator<=>.
+      //! They return whatever the value types' comparisons return, e.g. bool, or a simd_mask for SIMD vectors, and let
+      //!    the compiler vectorize and if-convert them as it would the bare values.
+      //! Each is constrained on its own operation, so neither it nor operator<=> is more constrained, and overload
+      //!    resolution prefers it to the rewritten operator<=>.
+      template<arithmetic T>
+         requires requires (value_type aLeft, T aRight) { aLeft == aRight; }
+      constexpr friend auto operator==(const quantity& aLeft, const quantity<dimension, T>& aRight) noexcept
+      {
+         return aLeft.get_standard() == aRight.get_standard();
+      }
+      template<arithmetic T>
+         requires requires (value_type aLeft, T aRight) { aLeft != aRight; }
+      constexpr friend auto operator!=(const quantity& aLeft, const quantity<dimension, T>& aRight) noexcept
+      {
+         return aLeft.get_standard() != aRight.get_standard();
+      }
+      template<arithmetic T>
+         requires requires (value_type aLeft, T aRight) { aLeft < aRight; }
+      constexpr friend auto operator<(const quantity& aLeft, const quantity<dimension, T>& aRight) noexcept
+      {
+         return aLeft.get_standard() < aRight.get_standard();
+      }
+      template<arithmetic T>
+         requires requires (value_type aLeft, T aRight) { aLeft <= aRight; }
+      constexpr friend auto operator<=(const quantity& aLeft, const quantity<dimension, T>& aRight) noexcept
+      {
+         return aLeft.get_standard() <= aRight.get_standard();
+      }
+      template<arithmetic T>
+         requires requires (value_type aLeft, T aRight) { aLeft > aRight; }
+      constexpr friend auto operator>(const quantity& aLeft, const quantity<dimension, T>& aRight) noexcept
+      {
+         return aLeft.get_standard() > aRight.get_standard();
+      }
+      template<arithmetic T>
+         requires requires (value_type aLeft, T aRight) { aLeft >= aRight; }
+      constexpr friend auto operator>=(const quantity& aLeft, const quantity<dimension, T>& aRight) noexcept
+      {
+         return aLeft.get_standard() >= aRight.get_standard();
+      }
+
    private:
       value_type mStandardValue = value_type();
    };
+
+   static_assert(rgf::detail::is_zero_overhead_wrapper_v<quantity<dimension_t<>, float>>);
+   static_assert(rgf::detail::is_zero_overhead_wrapper_v<quantity<dimension_t<>, double>>);
+   static_assert(rgf::detail::is_zero_overhead_wrapper_v<quantity<dimension_t<>, long long>>);
 }
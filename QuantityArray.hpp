@@ -0,0 +1,743 @@
+#pragma once
+
+#include "Dimension.hpp"
+#include "Quantity.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <compare>
+#include <concepts>
+#include <cstddef>
+#include <initializer_list>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace rgf
+{
+   //! Alignment in bytes of the storage owned by quantity_array.
+   //! 64 bytes is one cache line and the width of an AVX-512 register.
+   inline constexpr std::size_t quantity_array_alignment = 64;
+
+   //! Concept satisfied by the lazy element-wise expressions built in QuantityExpression.hpp.
+   //! An expression has a dimension, a value_type and a size(), and computes element i in standard units on demand.
+   template<typename T>
+   concept quantity_expression = requires (const T& aExpression, std::size_t aIndex)
+   {
+      requires T::is_quantity_expression;
+      typename T::dimension;
+      typename T::value_type;
+      { aExpression.size() } -> std::same_as<std::size_t>;
+      { aExpression[aIndex] } -> std::convertible_to<typename T::value_type>;
+   };
+
+   //! quantity_reference<DIMENSION, VALUE_TYPE> is a proxy for a quantity stored as a raw value_type.
+   //! It is returned when indexing mutable quantity_span and quantity_array objects.
+   //! Assigning through a quantity_reference writes the referenced value; it never rebinds.
+   template<dimension_type DIMENSION, arithmetic VALUE_TYPE>
+   class quantity_reference
+   {
+   public:
+      using dimension = DIMENSION;
+      using value_type = VALUE_TYPE;
+
+      using quantity_type = quantity<dimension, value_type>;
+
+      constexpr explicit quantity_reference(value_type& aValue) noexcept
+         : mValue(&aValue)
+      {}
+      constexpr quantity_reference(const quantity_reference&) = default;
+
+      constexpr const quantity_reference& operator=(const quantity_reference& aOther) const noexcept
+      {
+         *mValue = *aOther.mValue;
+         return *this;
+      }
+      constexpr const quantity_reference& operator=(const quantity_type& aQuantity) const noexcept
+      {
+         *mValue = aQuantity.get_standard();
+         return *this;
+      }
+
+      constexpr operator quantity_type() const noexcept
+      {
+         return { std::in_place, *mValue };
+      }
+
+      //! Accessor for the referenced value in standard units.
+      constexpr value_type get_standard() const noexcept
+      {
+         return *mValue;
+      }
+      //! Mutator for the referenced value in standard units.
+      constexpr void set_standard_value(value_type aValue) const noexcept
+      {
+         *mValue = aValue;
+      }
+
+      template<unit_type<quantity_type> UNIT>
+      constexpr auto get(const UNIT& aUnit) const
+      {
+         return quantity_type(*this).get(aUnit);
+      }
+
+      //! In-place operators forward to the corresponding quantity operators.
+      constexpr const quantity_reference& operator+=(const quantity_type& aOther) const noexcept
+      {
+         *mValue += aOther.get_standard();
+         return *this;
+      }
+      constexpr const quantity_reference& operator-=(const quantity_type& aOther) const noexcept
+      {
+         *mValue -= aOther.get_standard();
+         return *this;
+      }
+      constexpr const quantity_reference& operator*=(value_type aValue) const noexcept
+      {
+         *mValue *= aValue;
+         return *this;
+      }
+      constexpr const quantity_reference& operator/=(value_type aValue) const noexcept
+      {
+         *mValue /= aValue;
+         return *this;
+      }
+
+      //! Swaps the referenced values, allowing mutable quantity ranges to be sorted and permuted.
+      constexpr friend void swap(const quantity_reference& aLeft, const quantity_reference& aRight) noexcept
+      {
+         std::swap(*aLeft.mValue, *aRight.mValue);
+      }
+
+   private:
+      value_type* mValue;
+   };
+
+   namespace detail
+   {
+      //! Random access iterator over raw values that presents each element as a quantity.
+      //! Mutable iterators dereference to quantity_reference; const iterators dereference to a quantity by value.
+      template<dimension_type DIMENSION, typename ELEMENT_TYPE>
+      class quantity_iterator
+      {
+      public:
+         using iterator_concept = std::random_access_iterator_tag;
+         using iterator_category = std::random_access_iterator_tag;
+         using value_type = quantity<DIMENSION, std::remove_const_t<ELEMENT_TYPE>>;
+         using difference_type = std::ptrdiff_t;
+         using reference = std::conditional_t<std::is_const_v<ELEMENT_TYPE>,
+            value_type, quantity_reference<DIMENSION, std::remove_const_t<ELEMENT_TYPE>>>;
+
+         constexpr quantity_iterator() noexcept = default;
+         constexpr explicit quantity_iterator(ELEMENT_TYPE* aPointer) noexcept
+            : mPointer(aPointer)
+         {}
+
+         //! Mutable iterators are convertible to const iterators.
+         constexpr operator quantity_iterator<DIMENSION, const ELEMENT_TYPE>() const noexcept
+            requires (!std::is_const_v<ELEMENT_TYPE>)
+         {
+            return quantity_iterator<DIMENSION, const ELEMENT_TYPE>(mPointer);
+         }
+
+         constexpr ELEMENT_TYPE* base() const noexcept
+         {
+            return mPointer;
+         }
+
+         constexpr reference operator*() const noexcept
+         {
+            return make_reference(*mPointer);
+         }
+         constexpr reference operator[](difference_type aOffset) const noexcept
+         {
+            return make_reference(mPointer[aOffset]);
+         }
+
+         constexpr quantity_iterator& operator++() noexcept
+         {
+            ++mPointer;
+            return *this;
+         }
+         constexpr quantity_iterator operator++(int) noexcept
+         {
+            return quantity_iterator(mPointer++);
+         }
+         constexpr quantity_iterator& operator--() noexcept
+         {
+            --mPointer;
+            return *this;
+         }
+         constexpr quantity_iterator operator--(int) noexcept
+         {
+            return quantity_iterator(mPointer--);
+         }
+         constexpr quantity_iterator& operator+=(difference_type aOffset) noexcept
+         {
+            mPointer += aOffset;
+            return *this;
+         }
+         constexpr quantity_iterator& operator-=(difference_type aOffset) noexcept
+         {
+            mPointer -= aOffset;
+            return *this;
+         }
+
+         constexpr friend quantity_iterator operator+(quantity_iterator aIterator, difference_type aOffset) noexcept
+         {
+            return aIterator += aOffset;
+         }
+         constexpr friend quantity_iterator operator+(difference_type aOffset, quantity_iterator aIterator) noexcept
+         {
+            return aIterator += aOffset;
+         }
+         constexpr friend quantity_iterator operator-(quantity_iterator aIterator, difference_type aOffset) noexcept
+         {
+            return aIterator -= aOffset;
+         }
+         constexpr friend difference_type operator-(quantity_iterator aLeft, quantity_iterator aRight) noexcept
+         {
+            return aLeft.mPointer - aRight.mPointer;
+         }
+
+         constexpr friend bool operator==(quantity_iterator aLeft, quantity_iterator aRight) noexcept = default;
+         constexpr friend auto operator<=>(quantity_iterator aLeft, quantity_iterator aRight) noexcept = default;
+
+      private:
+         constexpr static reference make_reference(ELEMENT_TYPE& aValue) noexcept
+         {
+            if constexpr (std::is_const_v<ELEMENT_TYPE>)
+            {
+               return { std::in_place, aValue };
+            }
+            else
+            {
+               return reference(aValue);
+            }
+         }
+
+         ELEMENT_TYPE* mPointer = nullptr;
+      };
+
+      //! Deleter for storage allocated with quantity_array_alignment.
+      struct aligned_deleter
+      {
+         void operator()(void* aPointer) const noexcept
+         {
+            ::operator delete[](aPointer, std::align_val_t{ quantity_array_alignment });
+         }
+      };
+
+      //! Applies aOperation element-wise to aLeft and aRight and writes the results to aOut.
+      //! All three buffers must be aligned to quantity_array_alignment so the loop can be vectorized without peeling.
+      template<typename OUT, typename L, typename R, typename OPERATION>
+      void aligned_transform(const L* aLeft, const R* aRight, OUT* aOut, std::size_t aSize, OPERATION aOperation) noexcept
+      {
+         const L* left = std::assume_aligned<quantity_array_alignment>(aLeft);
+         const R* right = std::assume_aligned<quantity_array_alignment>(aRight);
+         OUT* out = std::assume_aligned<quantity_array_alignment>(aOut);
+         for (std::size_t i = 0; i < aSize; ++i)
+         {
+            out[i] = aOperation(left[i], right[i]);
+         }
+      }
+
+      //! Applies aOperation element-wise to aValues and writes the results to aOut.
+      //! Both buffers must be aligned to quantity_array_alignment.
+      template<typename OUT, typename IN, typename OPERATION>
+      void aligned_transform(const IN* aValues, OUT* aOut, std::size_t aSize, OPERATION aOperation) noexcept
+      {
+         const IN* values = std::assume_aligned<quantity_array_alignment>(aValues);
+         OUT* out = std::assume_aligned<quantity_array_alignment>(aOut);
+         for (std::size_t i = 0; i < aSize; ++i)
+         {
+            out[i] = aOperation(values[i]);
+         }
+      }
+   }
+
+   //! quantity_span<DIMENSION, ELEMENT_TYPE> is a non-owning view of contiguous quantities stored as raw values.
+   //! ELEMENT_TYPE may be const-qualified to produce a read-only view, as with std::span.
+   //! Elements are accessed as quantities, while data() and values() expose the underlying values for bulk kernels.
+   template<dimension_type DIMENSION, typename ELEMENT_TYPE>
+      requires arithmetic<std::remove_const_t<ELEMENT_TYPE>>
+   class quantity_span
+   {
+   public:
+      using dimension = DIMENSION;
+      using element_type = ELEMENT_TYPE;
+      using value_type = std::remove_const_t<element_type>;
+
+      using quantity_type = quantity<dimension, value_type>;
+
+      using size_type = std::size_t;
+      using difference_type = std::ptrdiff_t;
+      using iterator = rgf::detail::quantity_iterator<dimension, element_type>;
+      using reference = std::iter_reference_t<iterator>;
+
+      constexpr quantity_span() noexcept = default;
+      constexpr quantity_span(const quantity_span&) noexcept = default;
+
+      constexpr quantity_span(element_type* aData, size_type aSize) noexcept
+         : mData(aData)
+         , mSize(aSize)
+      {}
+
+      //! Constructs a view over raw values that are already in standard units.
+      constexpr explicit quantity_span(std::span<element_type> aValues) noexcept
+         : mData(aValues.data())
+         , mSize(aValues.size())
+      {}
+
+      //! Mutable spans are implicitly convertible to read-only spans.
+      template<typename OTHER_ELEMENT_TYPE>
+         requires std::same_as<element_type, const OTHER_ELEMENT_TYPE>
+      constexpr quantity_span(const quantity_span<dimension, OTHER_ELEMENT_TYPE>& aOther) noexcept
+         : mData(aOther.data())
+         , mSize(aOther.size())
+      {}
+
+      constexpr quantity_span& operator=(const quantity_span&) noexcept = default;
+
+      constexpr element_type* data() const noexcept
+      {
+         return mData;
+      }
+      constexpr size_type size() const noexcept
+      {
+         return mSize;
+      }
+      constexpr bool empty() const noexcept
+      {
+         return mSize == 0;
+      }
+
+      //! Returns the underlying values in standard units.
+      constexpr std::span<element_type> values() const noexcept
+      {
+         return { mData, mSize };
+      }
+
+      constexpr reference operator[](size_type aIndex) const noexcept
+      {
+         assert(aIndex < mSize);
+         return begin()[aIndex];
+      }
+
+      constexpr iterator begin() const noexcept
+      {
+         return iterator(mData);
+      }
+      constexpr iterator end() const noexcept
+      {
+         return iterator(mData + mSize);
+      }
+
+      //! Returns a view of aCount elements starting at aOffset.
+      constexpr quantity_span subspan(size_type aOffset, size_type aCount) const noexcept
+      {
+         assert(aOffset <= mSize && aCount <= mSize - aOffset);
+         return { mData + aOffset, aCount };
+      }
+
+   private:
+      element_type* mData = nullptr;
+      size_type mSize = 0;
+   };
+
+   //! quantity_array<DIMENSION, VALUE_TYPE> owns a contiguous array of quantities with the given dimension.
+   //! Values are stored as raw value_type in standard units, aligned to quantity_array_alignment.
+   //! Whole-array arithmetic follows the same dimension rules as quantity.
+   //! Operands of binary operators must have the same size.
+   template<dimension_type DIMENSION, arithmetic VALUE_TYPE = double>
+   class quantity_array
+   {
+   public:
+      using dimension = DIMENSION;
+      using value_type = VALUE_TYPE;
+
+      using quantity_type = quantity<dimension, value_type>;
+      using scalar_type = typename quantity_type::scalar_type;
+
+      using size_type = std::size_t;
+      using difference_type = std::ptrdiff_t;
+      using span_type = quantity_span<dimension, value_type>;
+      using const_span_type = quantity_span<dimension, const value_type>;
+      using iterator = typename span_type::iterator;
+      using const_iterator = typename const_span_type::iterator;
+      using reference = typename span_type::reference;
+      using const_reference = typename const_span_type::reference;
+
+      //! When default-constructed, the array is empty.
+      quantity_array() noexcept = default;
+
+      //! Constructs an array of aSize value-initialized quantities.
+      explicit quantity_array(size_type aSize)
+         : quantity_array(aSize, quantity_type())
+      {}
+      //! Constructs an array of aSize copies of aValue.
+      quantity_array(size_type aSize, const quantity_type& aValue)
+         : mData(allocate(aSize))
+         , mSize(aSize)
+      {
+         std::fill_n(mData.get(), mSize, aValue.get_standard());
+      }
+      quantity_array(std::initializer_list<quantity_type> aValues)
+         : mData(allocate(aValues.size()))
+         , mSize(aValues.size())
+      {
+         std::transform(aValues.begin(), aValues.end(), mData.get(),
+            [](const quantity_type& aValue) { return aValue.get_standard(); });
+      }
+      //! Copies the contents of a span into a new array.
+      explicit quantity_array(const_span_type aValues)
+         : mData(allocate(aValues.size()))
+         , mSize(aValues.size())
+      {
+         std::copy_n(aValues.data(), mSize, mData.get());
+      }
+
+      //! Evaluates a lazy expression in a single pass, see QuantityExpression.hpp.
+      template<quantity_expression EXPRESSION>
+         requires std::same_as<typename EXPRESSION::dimension, dimension>
+      quantity_array(const EXPRESSION& aExpression)
+         : quantity_array(std::in_place, aExpression.size())
+      {
+         evaluate(aExpression);
+      }
+
+      quantity_array(const quantity_array& aOther)
+         : quantity_array(aOther.span())
+      {}
+      quantity_array(quantity_array&& aOther) noexcept
+         : mData(std::move(aOther.mData))
+         , mSize(std::exchange(aOther.mSize, 0))
+      {}
+
+      quantity_array& operator=(const quantity_array& aOther)
+      {
+         if (this != &aOther)
+         {
+            *this = quantity_array(aOther);
+         }
+         return *this;
+      }
+      quantity_array& operator=(quantity_array&& aOther) noexcept
+      {
+         mData = std::move(aOther.mData);
+         mSize = std::exchange(aOther.mSize, 0);
+         return *this;
+      }
+      //! Evaluates a lazy expression in a single pass, reusing the storage when the sizes match.
+      //! The expression may refer to *this, since each element only depends on the elements at the same index.
+      template<quantity_expression EXPRESSION>
+         requires std::same_as<typename EXPRESSION::dimension, dimension>
+      quantity_array& operator=(const EXPRESSION& aExpression)
+      {
+         if (mSize != aExpression.size())
+         {
+            *this = quantity_array(aExpression);
+         }
+         else
+         {
+            evaluate(aExpression);
+         }
+         return *this;
+      }
+
+      value_type* data() noexcept
+      {
+         return mData.get();
+      }
+      const value_type* data() const noexcept
+      {
+         return mData.get();
+      }
+      size_type size() const noexcept
+      {
+         return mSize;
+      }
+      bool empty() const noexcept
+      {
+         return mSize == 0;
+      }
+
+      //! Returns the underlying values in standard units.
+      std::span<value_type> values() noexcept
+      {
+         return { data(), mSize };
+      }
+      std::span<const value_type> values() const noexcept
+      {
+         return { data(), mSize };
+      }
+
+      span_type span() noexcept
+      {
+         return { data(), mSize };
+      }
+      const_span_type span() const noexcept
+      {
+         return { data(), mSize };
+      }
+      operator span_type() noexcept
+      {
+         return span();
+      }
+      operator const_span_type() const noexcept
+      {
+         return span();
+      }
+
+      reference operator[](size_type aIndex) noexcept
+      {
+         return span()[aIndex];
+      }
+      const_reference operator[](size_type aIndex) const noexcept
+      {
+         return span()[aIndex];
+      }
+
+      iterator begin() noexcept
+      {
+         return span().begin();
+      }
+      iterator end() noexcept
+      {
+         return span().end();
+      }
+      const_iterator begin() const noexcept
+      {
+         return span().begin();
+      }
+      const_iterator end() const noexcept
+      {
+         return span().end();
+      }
+
+      //! In-place addition and subtraction operators.
+      //! Both arrays must have the same size.
+      quantity_array& operator+=(const quantity_array& aOther) noexcept
+      {
+         assert(mSize == aOther.size());
+         rgf::detail::aligned_transform(data(), aOther.data(), data(), mSize,
+            [](value_type aLeft, value_type aRight) { return aLeft + aRight; });
+         return *this;
+      }
+      quantity_array& operator-=(const quantity_array& aOther) noexcept
+      {
+         assert(mSize == aOther.size());
+         rgf::detail::aligned_transform(data(), aOther.data(), data(), mSize,
+            [](value_type aLeft, value_type aRight) { return aLeft - aRight; });
+         return *this;
+      }
+      //! Lazy expressions are added or subtracted in the same pass that evaluates them.
+      template<quantity_expression EXPRESSION>
+         requires std::same_as<typename EXPRESSION::dimension, dimension>
+      quantity_array& operator+=(const EXPRESSION& aExpression) noexcept
+      {
+         assert(mSize == aExpression.size());
+         value_type* values = std::assume_aligned<quantity_array_alignment>(data());
+         for (size_type i = 0; i < mSize; ++i)
+         {
+            values[i] += aExpression[i];
+         }
+         return *this;
+      }
+      template<quantity_expression EXPRESSION>
+         requires std::same_as<typename EXPRESSION::dimension, dimension>
+      quantity_array& operator-=(const EXPRESSION& aExpression) noexcept
+      {
+         assert(mSize == aExpression.size());
+         value_type* values = std::assume_aligned<quantity_array_alignment>(data());
+         for (size_type i = 0; i < mSize; ++i)
+         {
+            values[i] -= aExpression[i];
+         }
+         return *this;
+      }
+
+      //! In-place multiplication and division operators.
+      //! Only scalar values allowed on the right side of the expression.
+      quantity_array& operator*=(value_type aValue) noexcept
+      {
+         rgf::detail::aligned_transform(data(), data(), mSize,
+            [aValue](value_type aLeft) { return aLeft * aValue; });
+         return *this;
+      }
+      quantity_array& operator*=(const scalar_type& aOther) noexcept
+      {
+         return *this *= aOther.get_standard();
+      }
+      quantity_array& operator/=(value_type aValue) noexcept
+      {
+         rgf::detail::aligned_transform(data(), data(), mSize,
+            [aValue](value_type aLeft) { return aLeft / aValue; });
+         return *this;
+      }
+      quantity_array& operator/=(const scalar_type& aOther) noexcept
+      {
+         return *this /= aOther.get_standard();
+      }
+
+      //! Unary minus operator.
+      quantity_array operator-() const
+      {
+         return transformed<dimension, value_type>(*this, [](value_type aValue) { return -aValue; });
+      }
+
+      //! Addition and subtraction operators.
+      //! Both arrays must have the same dimension and size.
+      template<arithmetic T>
+      friend quantity_array<dimension, sum_t<value_type, T>>
+         operator+(const quantity_array& aLeft, const quantity_array<dimension, T>& aRight)
+      {
+         return transformed<dimension, sum_t<value_type, T>>(aLeft, aRight,
+            [](value_type aL, T aR) { return aL + aR; });
+      }
+      template<arithmetic T>
+      friend quantity_array<dimension, difference_t<value_type, T>>
+         operator-(const quantity_array& aLeft, const quantity_array<dimension, T>& aRight)
+      {
+         return transformed<dimension, difference_t<value_type, T>>(aLeft, aRight,
+            [](value_type aL, T aR) { return aL - aR; });
+      }
+
+      //! Multiplication operators.
+      //! Overload 1 multiplies element-wise; both arrays must have the same size.
+      //! Overloads 2 through 5 multiply every element by the same quantity or value.
+      template<dimension_type RDIM, arithmetic T>
+      friend quantity_array<dimension_product_t<dimension, RDIM>, product_t<value_type, T>>
+         operator*(const quantity_array& aLeft, const quantity_array<RDIM, T>& aRight)
+      {
+         return transformed<dimension_product_t<dimension, RDIM>, product_t<value_type, T>>(aLeft, aRight,
+            [](value_type aL, T aR) { return aL * aR; });
+      }
+      template<dimension_type RDIM, arithmetic T>
+      friend quantity_array<dimension_product_t<dimension, RDIM>, product_t<value_type, T>>
+         operator*(const quantity_array& aLeft, const quantity<RDIM, T>& aRight)
+      {
+         return transformed<dimension_product_t<dimension, RDIM>, product_t<value_type, T>>(aLeft,
+            [aR = aRight.get_standard()](value_type aL) { return aL * aR; });
+      }
+      template<dimension_type LDIM, arithmetic T>
+      friend quantity_array<dimension_product_t<LDIM, dimension>, product_t<T, value_type>>
+         operator*(const quantity<LDIM, T>& aLeft, const quantity_array& aRight)
+      {
+         return transformed<dimension_product_t<LDIM, dimension>, product_t<T, value_type>>(aRight,
+            [aL = aLeft.get_standard()](value_type aR) { return aL * aR; });
+      }
+      template<arithmetic T>
+      friend quantity_array<dimension, product_t<value_type, T>>
+         operator*(const quantity_array& aLeft, T aRight)
+      {
+         return transformed<dimension, product_t<value_type, T>>(aLeft,
+            [aRight](value_type aL) { return aL * aRight; });
+      }
+      template<arithmetic T>
+      friend quantity_array<dimension, product_t<T, value_type>>
+         operator*(T aLeft, const quantity_array& aRight)
+      {
+         return transformed<dimension, product_t<T, value_type>>(aRight,
+            [aLeft](value_type aR) { return aLeft * aR; });
+      }
+
+      //! Division operators.
+      //! Overload 1 divides element-wise; both arrays must have the same size.
+      //! Overloads 2 through 5 divide every element by, or into, the same quantity or value.
+      template<dimension_type RDIM, arithmetic T>
+      friend quantity_array<dimension_quotient_t<dimension, RDIM>, quotient_t<value_type, T>>
+         operator/(const quantity_array& aLeft, const quantity_array<RDIM, T>& aRight)
+      {
+         return transformed<dimension_quotient_t<dimension, RDIM>, quotient_t<value_type, T>>(aLeft, aRight,
+            [](value_type aL, T aR) { return aL / aR; });
+      }
+      template<dimension_type RDIM, arithmetic T>
+      friend quantity_array<dimension_quotient_t<dimension, RDIM>, quotient_t<value_type, T>>
+         operator/(const quantity_array& aLeft, const quantity<RDIM, T>& aRight)
+      {
+         return transformed<dimension_quotient_t<dimension, RDIM>, quotient_t<value_type, T>>(aLeft,
+            [aR = aRight.get_standard()](value_type aL) { return aL / aR; });
+      }
+      template<dimension_type LDIM, arithmetic T>
+      friend quantity_array<dimension_quotient_t<LDIM, dimension>, quotient_t<T, value_type>>
+         operator/(const quantity<LDIM, T>& aLeft, const quantity_array& aRight)
+      {
+         return transformed<dimension_quotient_t<LDIM, dimension>, quotient_t<T, value_type>>(aRight,
+            [aL = aLeft.get_standard()](value_type aR) { return aL / aR; });
+      }
+      template<arithmetic T>
+      friend quantity_array<dimension, quotient_t<value_type, T>>
+         operator/(const quantity_array& aLeft, T aRight)
+      {
+         return transformed<dimension, quotient_t<value_type, T>>(aLeft,
+            [aRight](value_type aL) { return aL / aRight; });
+      }
+      template<arithmetic T>
+      friend quantity_array<dimension_inverse_t<dimension>, quotient_t<T, value_type>>
+         operator/(T aLeft, const quantity_array& aRight)
+      {
+         return transformed<dimension_inverse_t<dimension>, quotient_t<T, value_type>>(aRight,
+            [aLeft](value_type aR) { return aLeft / aR; });
+      }
+
+   private:
+      template<dimension_type, arithmetic>
+      friend class quantity_array;
+
+      using storage_type = std::unique_ptr<value_type[], rgf::detail::aligned_deleter>;
+
+      //! Constructs an array of aSize elements without initializing them.
+      //! Only used internally, where every element is written immediately afterwards.
+      quantity_array(std::in_place_t, size_type aSize)
+         : mData(allocate(aSize))
+         , mSize(aSize)
+      {}
+
+      static storage_type allocate(size_type aSize)
+      {
+         static_assert(std::is_trivially_copyable_v<value_type> && std::is_trivially_destructible_v<value_type>,
+            "quantity_array storage is never constructed or destroyed element-wise.");
+         if (aSize == 0)
+         {
+            return nullptr;
+         }
+         return storage_type(static_cast<value_type*>(
+            ::operator new[](aSize * sizeof(value_type), std::align_val_t{ quantity_array_alignment })));
+      }
+
+      template<quantity_expression EXPRESSION>
+      void evaluate(const EXPRESSION& aExpression) noexcept
+      {
+         value_type* values = std::assume_aligned<quantity_array_alignment>(data());
+         for (size_type i = 0; i < mSize; ++i)
+         {
+            values[i] = static_cast<value_type>(aExpression[i]);
+         }
+      }
+
+      template<dimension_type RESULT_DIM, arithmetic RESULT_TYPE, typename OPERATION>
+      static quantity_array<RESULT_DIM, RESULT_TYPE> transformed(const quantity_array& aValues, OPERATION aOperation)
+      {
+         quantity_array<RESULT_DIM, RESULT_TYPE> result(std::in_place, aValues.size());
+         rgf::detail::aligned_transform(aValues.data(), result.data(), aValues.size(), aOperation);
+         return result;
+      }
+
+      template<dimension_type RESULT_DIM, arithmetic RESULT_TYPE, dimension_type RDIM, arithmetic T, typename OPERATION>
+      static quantity_array<RESULT_DIM, RESULT_TYPE> transformed(const quantity_array& aLeft,
+         const quantity_array<RDIM, T>& aRight, OPERATION aOperation)
+      {
+         assert(aLeft.size() == aRight.size());
+         quantity_array<RESULT_DIM, RESULT_TYPE> result(std::in_place, aLeft.size());
+         rgf::detail::aligned_transform(aLeft.data(), aRight.data(), result.data(), aLeft.size(), aOperation);
+         return result;
+      }
+
+      storage_type mData;
+      size_type mSize = 0;
+   };
+}
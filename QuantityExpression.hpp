@@ -0,0 +1,311 @@
+#pragma once
+
+#include "Dimension.hpp"
+#include "Quantity.hpp"
+#include "QuantityArray.hpp"
+
+#include <cassert>
+#include <concepts>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+
+//! Lazy element-wise arithmetic on quantity arrays.
+//! rgf::lazy(array) starts an expression, and the usual operators then build a typed tree instead of computing anything,
+//!    e.g. quantity_array<energy_dimension> e = 0.5 * rgf::lazy(m) * v * v;
+//! The tree is evaluated in a single loop when it is assigned to a quantity_array, so the example above reads m and v once
+//!    and writes e once, where the eager quantity_array operators would allocate and traverse two temporary arrays.
+//! Result dimensions follow the quantity operators, and adding or subtracting mismatched dimensions does not compile.
+//! Expressions refer to their arrays rather than copying them, so they should be assigned before the arrays go out of scope,
+//!    rather than stored with auto.
+namespace rgf
+{
+   //! array_expression is the leaf of an expression, and refers to contiguous values in standard units.
+   template<dimension_type DIMENSION, arithmetic VALUE_TYPE>
+   class array_expression
+   {
+   public:
+      using dimension = DIMENSION;
+      using value_type = VALUE_TYPE;
+
+      constexpr static bool is_quantity_expression = true;
+      constexpr static bool is_broadcast = false;
+
+      constexpr array_expression(const value_type* aValues, std::size_t aSize) noexcept
+         : mValues(aValues)
+         , mSize(aSize)
+      {}
+
+      constexpr std::size_t size() const noexcept
+      {
+         return mSize;
+      }
+      constexpr value_type operator[](std::size_t aIndex) const noexcept
+      {
+         return mValues[aIndex];
+      }
+
+   private:
+      const value_type* mValues;
+      std::size_t mSize;
+   };
+
+   //! scalar_expression repeats a single value for every element, e.g. the 0.5 in 0.5 * lazy(m).
+   //! It has no size of its own, so it only appears as an operand of a larger expression, which tracks its dimension.
+   template<arithmetic VALUE_TYPE>
+   class scalar_expression
+   {
+   public:
+      using value_type = VALUE_TYPE;
+
+      constexpr static bool is_broadcast = true;
+
+      constexpr explicit scalar_expression(value_type aValue) noexcept
+         : mValue(aValue)
+      {}
+
+      constexpr value_type operator[](std::size_t) const noexcept
+      {
+         return mValue;
+      }
+
+   private:
+      value_type mValue;
+   };
+
+   //! unary_expression applies OPERATION to each element of OPERAND, keeping its dimension.
+   template<typename OPERAND, typename OPERATION>
+   class unary_expression
+   {
+   public:
+      using dimension = typename OPERAND::dimension;
+      using value_type = std::invoke_result_t<OPERATION, typename OPERAND::value_type>;
+
+      constexpr static bool is_quantity_expression = true;
+      constexpr static bool is_broadcast = false;
+
+      constexpr explicit unary_expression(const OPERAND& aOperand) noexcept
+         : mOperand(aOperand)
+      {}
+
+      constexpr std::size_t size() const noexcept
+      {
+         return mOperand.size();
+      }
+      constexpr value_type operator[](std::size_t aIndex) const noexcept
+      {
+         return OPERATION()(mOperand[aIndex]);
+      }
+
+   private:
+      OPERAND mOperand;
+   };
+
+   //! binary_expression applies OPERATION to the elements of LEFT and RIGHT at each index.
+   //! DIMENSION is the dimension of the result. At most one operand is a scalar_expression.
+   template<dimension_type DIMENSION, typename LEFT, typename RIGHT, typename OPERATION>
+   class binary_expression
+   {
+   public:
+      using dimension = DIMENSION;
+      using value_type = std::invoke_result_t<OPERATION, typename LEFT::value_type, typename RIGHT::value_type>;
+
+      constexpr static bool is_quantity_expression = true;
+      constexpr static bool is_broadcast = false;
+
+      constexpr binary_expression(const LEFT& aLeft, const RIGHT& aRight) noexcept
+         : mLeft(aLeft)
+         , mRight(aRight)
+      {
+         if constexpr (!LEFT::is_broadcast && !RIGHT::is_broadcast)
+         {
+            assert(mLeft.size() == mRight.size());
+         }
+      }
+
+      constexpr std::size_t size() const noexcept
+      {
+         if constexpr (LEFT::is_broadcast)
+         {
+            return mRight.size();
+         }
+         else
+         {
+            return mLeft.size();
+         }
+      }
+      constexpr value_type operator[](std::size_t aIndex) const noexcept
+      {
+         return OPERATION()(mLeft[aIndex], mRight[aIndex]);
+      }
+
+   private:
+      LEFT mLeft;
+      RIGHT mRight;
+   };
+
+   //! Starts a lazy expression from an array or span.
+   //! Rvalue arrays are rejected, since the expression would outlive them.
+   template<dimension_type DIMENSION, arithmetic VALUE_TYPE>
+   constexpr array_expression<DIMENSION, VALUE_TYPE> lazy(const quantity_array<DIMENSION, VALUE_TYPE>& aValues) noexcept
+   {
+      return { aValues.data(), aValues.size() };
+   }
+   template<dimension_type DIMENSION, arithmetic VALUE_TYPE>
+   void lazy(const quantity_array<DIMENSION, VALUE_TYPE>&&) = delete;
+   template<dimension_type DIMENSION, typename ELEMENT_TYPE>
+   constexpr array_expression<DIMENSION, std::remove_const_t<ELEMENT_TYPE>> lazy(
+      quantity_span<DIMENSION, ELEMENT_TYPE> aValues) noexcept
+   {
+      return { aValues.data(), aValues.size() };
+   }
+
+   namespace detail
+   {
+      //! expression_operand<T>::make converts an operand of an expression operator into an expression node,
+      //!    and expression_operand<T>::dimension is the operand's dimension.
+      //! Arrays and spans become array_expression, and quantities and values become scalar_expression.
+      //! Values have no dimension member, since they take the scalar dimension of the other operand.
+      template<typename T>
+      struct expression_operand;
+      template<quantity_expression EXPRESSION>
+      struct expression_operand<EXPRESSION>
+      {
+         using dimension = typename EXPRESSION::dimension;
+
+         constexpr static const EXPRESSION& make(const EXPRESSION& aExpression) noexcept
+         {
+            return aExpression;
+         }
+      };
+      template<dimension_type DIMENSION, arithmetic VALUE_TYPE>
+      struct expression_operand<quantity_array<DIMENSION, VALUE_TYPE>>
+      {
+         using dimension = DIMENSION;
+
+         constexpr static array_expression<DIMENSION, VALUE_TYPE> make(const quantity_array<DIMENSION, VALUE_TYPE>& aValues) noexcept
+         {
+            return rgf::lazy(aValues);
+         }
+      };
+      template<dimension_type DIMENSION, typename ELEMENT_TYPE>
+      struct expression_operand<quantity_span<DIMENSION, ELEMENT_TYPE>>
+      {
+         using dimension = DIMENSION;
+
+         constexpr static array_expression<DIMENSION, std::remove_const_t<ELEMENT_TYPE>> make(
+            quantity_span<DIMENSION, ELEMENT_TYPE> aValues) noexcept
+         {
+            return rgf::lazy(aValues);
+         }
+      };
+      template<dimension_type DIMENSION, arithmetic VALUE_TYPE>
+      struct expression_operand<quantity<DIMENSION, VALUE_TYPE>>
+      {
+         using dimension = DIMENSION;
+
+         constexpr static scalar_expression<VALUE_TYPE> make(const quantity<DIMENSION, VALUE_TYPE>& aQuantity) noexcept
+         {
+            return scalar_expression<VALUE_TYPE>(aQuantity.get_standard());
+         }
+      };
+      template<arithmetic VALUE_TYPE>
+      struct expression_operand<VALUE_TYPE>
+      {
+         constexpr static scalar_expression<VALUE_TYPE> make(VALUE_TYPE aValue) noexcept
+         {
+            return scalar_expression<VALUE_TYPE>(aValue);
+         }
+      };
+
+      template<typename T>
+      using expression_node_t = std::remove_cvref_t<decltype(expression_operand<T>::make(std::declval<const T&>()))>;
+
+      //! The 'type' member alias of operand_dimension is the dimension of T when combined with OTHER.
+      template<typename T, typename OTHER>
+      struct operand_dimension
+      {
+         using type = typename expression_operand<T>::dimension;
+      };
+      template<arithmetic T, typename OTHER>
+      struct operand_dimension<T, OTHER>
+      {
+         using type = dimension_exponent_t<typename expression_operand<OTHER>::dimension, 0>;
+      };
+      template<typename T, typename OTHER>
+      using operand_dimension_t = typename operand_dimension<T, OTHER>::type;
+
+      //! Satisfied when L and R can be combined by an expression operator, which requires at least one to be an expression.
+      //! Operations between arrays alone remain eager, as before.
+      template<typename L, typename R>
+      concept expression_operands = (quantity_expression<L> || quantity_expression<R>)
+         && requires { typename expression_node_t<L>; typename expression_node_t<R>; };
+
+      template<typename L, typename R>
+      concept same_dimension_operands = expression_operands<L, R>
+         && requires { typename expression_operand<L>::dimension; typename expression_operand<R>::dimension; }
+         && std::same_as<typename expression_operand<L>::dimension, typename expression_operand<R>::dimension>;
+
+      template<typename DIMENSION, typename OPERATION, typename L, typename R>
+      constexpr auto make_binary_expression(const L& aLeft, const R& aRight) noexcept
+      {
+         return binary_expression<DIMENSION, expression_node_t<L>, expression_node_t<R>, OPERATION>(
+            expression_operand<L>::make(aLeft), expression_operand<R>::make(aRight));
+      }
+   }
+
+   //! Unary minus operator.
+   template<quantity_expression EXPRESSION>
+   constexpr unary_expression<EXPRESSION, std::negate<>> operator-(const EXPRESSION& aExpression) noexcept
+   {
+      return unary_expression<EXPRESSION, std::negate<>>(aExpression);
+   }
+
+   //! Addition and subtraction operators.
+   //! Both operands must have the same dimension. Either may be a quantity, which is added to or subtracted from every element.
+   template<typename L, typename R>
+      requires rgf::detail::same_dimension_operands<L, R>
+   constexpr auto operator+(const L& aLeft, const R& aRight) noexcept
+   {
+      using dimension = typename rgf::detail::expression_operand<L>::dimension;
+      return rgf::detail::make_binary_expression<dimension, std::plus<>>(aLeft, aRight);
+   }
+   template<typename L, typename R>
+      requires rgf::detail::same_dimension_operands<L, R>
+   constexpr auto operator-(const L& aLeft, const R& aRight) noexcept
+   {
+      using dimension = typename rgf::detail::expression_operand<L>::dimension;
+      return rgf::detail::make_binary_expression<dimension, std::minus<>>(aLeft, aRight);
+   }
+
+   //! Multiplication and division operators.
+   //! Either operand may be an array, a span, a quantity or a value.
+   template<typename L, typename R>
+      requires rgf::detail::expression_operands<L, R>
+   constexpr auto operator*(const L& aLeft, const R& aRight) noexcept
+   {
+      using dimension = dimension_product_t<rgf::detail::operand_dimension_t<L, R>, rgf::detail::operand_dimension_t<R, L>>;
+      return rgf::detail::make_binary_expression<dimension, std::multiplies<>>(aLeft, aRight);
+   }
+   template<typename L, typename R>
+      requires rgf::detail::expression_operands<L, R>
+   constexpr auto operator/(const L& aLeft, const R& aRight) noexcept
+   {
+      using dimension = dimension_quotient_t<rgf::detail::operand_dimension_t<L, R>, rgf::detail::operand_dimension_t<R, L>>;
+      return rgf::detail::make_binary_expression<dimension, std::divides<>>(aLeft, aRight);
+   }
+
+   //! Evaluates aExpression into aResults in a single pass, which must be the same size.
+   //! aResults may overlap the expression's arrays only if it refers to exactly the same elements.
+   template<quantity_expression EXPRESSION, dimension_type DIMENSION, arithmetic VALUE_TYPE>
+      requires std::same_as<typename EXPRESSION::dimension, DIMENSION>
+   constexpr void evaluate(const EXPRESSION& aExpression, quantity_span<DIMENSION, VALUE_TYPE> aResults) noexcept
+   {
+      assert(aResults.size() == aExpression.size());
+      VALUE_TYPE* results = aResults.data();
+      for (std::size_t i = 0; i < aResults.size(); ++i)
+      {
+         results[i] = static_cast<VALUE_TYPE>(aExpression[i]);
+      }
+   }
+}
@@ -0,0 +1,319 @@
+#pragma once
+
+#include "Dimension.hpp"
+#include "Quantity.hpp"
+#include "QuantityArray.hpp"
+
+#include <array>
+#include <cerrno>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+//! Quantity files store one column of quantities, so that it can be mapped straight back into memory.
+//! The layout is, with every integer in the writer's native byte order:
+//!
+//!    offset  size  field
+//!         0     8  magic, the characters "RGFQUANT"
+//!         8     4  format version, currently 1
+//!        12     4  0x01020304, so readers can detect a foreign byte order
+//!        16     1  value kind: 'f' for floating point, 'i' for signed and 'u' for unsigned integers, 'b' for bool,
+//!                  and 'c' for char, wchar_t, char8_t, char16_t and char32_t
+//!        17     1  value size in bytes
+//!        18     2  number of dimension bases, N
+//!        20     4  reserved, zero
+//!        24     8  number of values
+//!        32     8  offset of the first value from the start of the file, a multiple of quantity_array_alignment
+//!        40  16*N  for each base in order: 64-bit FNV-1a hash of dimension_base_name_v, 32-bit exponent, 4 reserved bytes
+//!
+//! Values follow at the data offset in standard units, as quantity_array stores them.
+//! Files are read without any conversion, so they must be opened on a machine with the writer's byte order.
+namespace rgf
+{
+   //! Thrown when a quantity file is malformed, or does not hold the requested dimension or value type.
+   class quantity_file_error : public std::runtime_error
+   {
+   public:
+      using std::runtime_error::runtime_error;
+   };
+
+   namespace detail
+   {
+      inline constexpr std::array<char, 8> quantity_file_magic = { 'R', 'G', 'F', 'Q', 'U', 'A', 'N', 'T' };
+      inline constexpr std::uint32_t quantity_file_version = 1;
+      inline constexpr std::uint32_t quantity_file_byte_order = 0x01020304;
+
+      struct quantity_file_header
+      {
+         std::array<char, 8> magic;
+         std::uint32_t version;
+         std::uint32_t byteOrder;
+         std::uint8_t valueKind;
+         std::uint8_t valueSize;
+         std::uint16_t baseCount;
+         std::uint32_t reserved;
+         std::uint64_t count;
+         std::uint64_t dataOffset;
+      };
+      static_assert(sizeof(quantity_file_header) == 40 && std::is_trivially_copyable_v<quantity_file_header>);
+
+      struct quantity_file_base
+      {
+         std::uint64_t nameHash;
+         std::int32_t exponent;
+         std::uint32_t reserved;
+
+         constexpr friend bool operator==(const quantity_file_base&, const quantity_file_base&) noexcept = default;
+      };
+      static_assert(sizeof(quantity_file_base) == 16 && std::is_trivially_copyable_v<quantity_file_base>);
+
+      //! The 'bases' member of quantity_file_dimension holds the base entries written to the header of a DIM file.
+      //! Every base of DIM must have a dimension_base_name_v.
+      template<dimension_type DIM>
+      struct quantity_file_dimension;
+      template<template<int> typename... BASE_TYPES, int... EXPONENTS>
+      struct quantity_file_dimension<dimension_t<BASE_TYPES<EXPONENTS>...>>
+      {
+         static_assert((!rgf::dimension_base_name_v<BASE_TYPES>.empty() && ...),
+            "Every base must specialize rgf::dimension_base_name_v to be stored in a file.");
+         constexpr static std::array<quantity_file_base, sizeof...(BASE_TYPES)> bases = {
+            quantity_file_base{ rgf::detail::fnv1a(rgf::dimension_base_name_v<BASE_TYPES>), EXPONENTS, 0 }... };
+      };
+
+      template<typename T>
+      constexpr bool is_character_v = std::is_same_v<T, char> || std::is_same_v<T, wchar_t> || std::is_same_v<T, char8_t>
+         || std::is_same_v<T, char16_t> || std::is_same_v<T, char32_t>;
+
+      //! bool and the character types have kinds of their own, so that e.g. a uint8_t column cannot be mapped as bool.
+      template<typename T>
+      constexpr std::uint8_t quantity_file_value_kind = std::is_same_v<T, bool> ? 'b' : is_character_v<T> ? 'c'
+         : std::is_floating_point_v<T> ? 'f' : std::is_signed_v<T> ? 'i' : 'u';
+
+      //! Returns the header expected for a file of aCount values of type T with dimension DIM.
+      template<dimension_type DIM, typename T>
+      constexpr quantity_file_header make_quantity_file_header(std::uint64_t aCount) noexcept
+      {
+         constexpr std::size_t baseCount = quantity_file_dimension<DIM>::bases.size();
+         constexpr std::size_t headerSize = sizeof(quantity_file_header) + baseCount * sizeof(quantity_file_base);
+         return {
+            quantity_file_magic, quantity_file_version, quantity_file_byte_order,
+            quantity_file_value_kind<T>, static_cast<std::uint8_t>(sizeof(T)), static_cast<std::uint16_t>(baseCount), 0,
+            aCount, (headerSize + quantity_array_alignment - 1) / quantity_array_alignment * quantity_array_alignment };
+      }
+   }
+
+   //! Writes aValues to a new quantity file at aPath, replacing any existing file.
+   //! Throws quantity_file_error if the file cannot be written.
+   template<dimension_type DIMENSION, typename ELEMENT_TYPE>
+      requires std::is_arithmetic_v<std::remove_const_t<ELEMENT_TYPE>>
+   void write_quantity_file(const std::filesystem::path& aPath, quantity_span<DIMENSION, ELEMENT_TYPE> aValues)
+   {
+      using value_type = std::remove_const_t<ELEMENT_TYPE>;
+      const auto header = rgf::detail::make_quantity_file_header<DIMENSION, value_type>(aValues.size());
+      const auto& bases = rgf::detail::quantity_file_dimension<DIMENSION>::bases;
+      const std::size_t basesSize = bases.size() * sizeof(rgf::detail::quantity_file_base);
+      const std::array<char, quantity_array_alignment> padding{};
+
+      std::ofstream file(aPath, std::ios::binary | std::ios::trunc);
+      file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+      file.write(reinterpret_cast<const char*>(bases.data()), static_cast<std::streamsize>(basesSize));
+      file.write(padding.data(), static_cast<std::streamsize>(header.dataOffset - sizeof(header) - basesSize));
+      file.write(reinterpret_cast<const char*>(aValues.data()), static_cast<std::streamsize>(aValues.size() * sizeof(value_type)));
+      file.close();
+      if (!file)
+      {
+         throw quantity_file_error("Failed to write quantity file " + aPath.string());
+      }
+   }
+   template<dimension_type DIMENSION, typename T>
+      requires std::is_arithmetic_v<T>
+   void write_quantity_file(const std::filesystem::path& aPath, const quantity_array<DIMENSION, T>& aValues)
+   {
+      rgf::write_quantity_file(aPath, aValues.span());
+   }
+
+   //! mapped_quantity_file<DIMENSION, VALUE_TYPE> maps a quantity file read-only into memory.
+   //! The values are not copied or parsed: span() views the mapped pages directly, and the operating system
+   //!    reads them from disk on first access, so opening even very large files takes constant time.
+   //! The constructor checks that the file holds DIMENSION and VALUE_TYPE in this machine's byte order,
+   //!    and throws quantity_file_error if not, or std::system_error if the file cannot be opened or mapped.
+   template<dimension_type DIMENSION, typename VALUE_TYPE = double>
+      requires std::is_arithmetic_v<VALUE_TYPE>
+   class mapped_quantity_file
+   {
+   public:
+      using dimension = DIMENSION;
+      using value_type = VALUE_TYPE;
+
+      using size_type = std::size_t;
+      using span_type = quantity_span<dimension, const value_type>;
+
+      explicit mapped_quantity_file(const std::filesystem::path& aPath)
+      {
+         const int descriptor = ::open(aPath.c_str(), O_RDONLY | O_CLOEXEC);
+         if (descriptor < 0)
+         {
+            throw std::system_error(errno, std::generic_category(), "Failed to open " + aPath.string());
+         }
+
+         struct stat status;
+         if (::fstat(descriptor, &status) != 0)
+         {
+            const int error = errno;
+            ::close(descriptor);
+            throw std::system_error(error, std::generic_category(), "Failed to stat " + aPath.string());
+         }
+         mMappingSize = static_cast<std::size_t>(status.st_size);
+
+         if (mMappingSize > 0)
+         {
+            void* mapping = ::mmap(nullptr, mMappingSize, PROT_READ, MAP_SHARED, descriptor, 0);
+            if (mapping == MAP_FAILED)
+            {
+               const int error = errno;
+               ::close(descriptor);
+               throw std::system_error(error, std::generic_category(), "Failed to map " + aPath.string());
+            }
+            mMapping = mapping;
+         }
+         // The mapping stays valid after the descriptor is closed.
+         ::close(descriptor);
+
+         try
+         {
+            validate(aPath);
+         }
+         catch (...)
+         {
+            unmap();
+            throw;
+         }
+      }
+
+      mapped_quantity_file(const mapped_quantity_file&) = delete;
+      mapped_quantity_file(mapped_quantity_file&& aOther) noexcept
+         : mMapping(std::exchange(aOther.mMapping, nullptr))
+         , mMappingSize(std::exchange(aOther.mMappingSize, 0))
+         , mValues(std::exchange(aOther.mValues, span_type()))
+      {}
+
+      mapped_quantity_file& operator=(const mapped_quantity_file&) = delete;
+      mapped_quantity_file& operator=(mapped_quantity_file&& aOther) noexcept
+      {
+         if (this != &aOther)
+         {
+            unmap();
+            mMapping = std::exchange(aOther.mMapping, nullptr);
+            mMappingSize = std::exchange(aOther.mMappingSize, 0);
+            mValues = std::exchange(aOther.mValues, span_type());
+         }
+         return *this;
+      }
+
+      ~mapped_quantity_file()
+      {
+         unmap();
+      }
+
+      //! Returns a read-only view of the mapped quantities.
+      //! The view is invalidated when *this is destroyed.
+      span_type span() const noexcept
+      {
+         return mValues;
+      }
+      operator span_type() const noexcept
+      {
+         return mValues;
+      }
+
+      size_type size() const noexcept
+      {
+         return mValues.size();
+      }
+
+   private:
+      void validate(const std::filesystem::path& aPath)
+      {
+         const auto fail = [&aPath](std::string_view aReason)
+         {
+            throw quantity_file_error(aPath.string() + ": " + std::string(aReason));
+         };
+
+         const auto& bases = rgf::detail::quantity_file_dimension<dimension>::bases;
+         rgf::detail::quantity_file_header header;
+         if (mMappingSize < sizeof(header))
+         {
+            fail("too small to be a quantity file");
+         }
+         std::memcpy(&header, mMapping, sizeof(header));
+
+         if (header.magic != rgf::detail::quantity_file_magic)
+         {
+            fail("not a quantity file");
+         }
+         if (header.byteOrder != rgf::detail::quantity_file_byte_order)
+         {
+            fail("written with a different byte order");
+         }
+         if (header.version != rgf::detail::quantity_file_version)
+         {
+            fail("unsupported format version " + std::to_string(header.version));
+         }
+
+         const auto expected = rgf::detail::make_quantity_file_header<dimension, value_type>(header.count);
+         if (header.valueKind != expected.valueKind || header.valueSize != expected.valueSize)
+         {
+            fail("value type does not match");
+         }
+         if (header.baseCount != bases.size())
+         {
+            fail("dimension does not match");
+         }
+         // The bases table follows the header, and the values follow the table.
+         const std::size_t basesSize = bases.size() * sizeof(rgf::detail::quantity_file_base);
+         if (mMappingSize < sizeof(header) + basesSize)
+         {
+            fail("truncated or corrupt");
+         }
+         if (basesSize > 0 && std::memcmp(static_cast<const char*>(mMapping) + sizeof(header), bases.data(), basesSize) != 0)
+         {
+            fail("dimension does not match");
+         }
+         if (header.dataOffset % quantity_array_alignment != 0 || header.dataOffset < sizeof(header) + basesSize
+            || header.dataOffset > mMappingSize || header.count > (mMappingSize - header.dataOffset) / sizeof(value_type))
+         {
+            fail("truncated or corrupt");
+         }
+
+         mValues = span_type(reinterpret_cast<const value_type*>(static_cast<const char*>(mMapping) + header.dataOffset),
+            static_cast<size_type>(header.count));
+      }
+
+      void unmap() noexcept
+      {
+         if (mMapping)
+         {
+            ::munmap(mMapping, mMappingSize);
+            mMapping = nullptr;
+         }
+      }
+
+      void* mMapping = nullptr;
+      std::size_t mMappingSize = 0;
+      span_type mValues;
+   };
+}
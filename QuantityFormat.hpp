@@ -0,0 +1,360 @@
+#pragma once
+
+#include "Absolute.hpp"
+#include "Dimension.hpp"
+#include "Quantity.hpp"
+#include "RuntimeDimension.hpp"
+#include "UnitParser.hpp"
+
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <charconv>
+#include <concepts>
+#include <cstdint>
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+#if __has_include(<format>)
+#include <format>
+#endif
+
+namespace rgf
+{
+   //! quantity_format describes how rgf::to_chars writes a quantity or absolute: a value, a space, and a unit symbol.
+   //! It is parsed from a specification of the form [.precision][unit], where unit is one of
+   //!    (nothing)  the standard units of the dimension, written as rgf::dimension_symbol_v, e.g. "9.81 m·s⁻²"
+   //!    auto       the standard units with the SI prefix that puts the value in [1, 1000), e.g. "12.5 km".
+   //!               Only dimensions of a single base to the first power are prefixed; others are written as with no unit.
+   //!    a unit     any expression accepted by rgf::parse_unit, written as given, e.g. "km/h"
+   //! Without a precision, values are written in the shortest form that reads back exactly.
+   //!    With one, they are written in fixed notation with that many decimals.
+   //! A quantity_format refers to the unit symbol in the specification, so the specification must outlive it.
+   class quantity_format
+   {
+   public:
+      //! When default-constructed, quantities are written in standard units at full precision.
+      constexpr quantity_format() noexcept = default;
+
+      //! Parses aSpecification, which must be entirely consumed.
+      //! Throws std::invalid_argument if it is malformed or names an unknown unit.
+      constexpr explicit quantity_format(std::string_view aSpecification)
+      {
+         const char* last = aSpecification.data() + aSpecification.size();
+         const auto [end, ec] = parse(aSpecification.data(), last);
+         if (ec != std::errc() || end != last)
+         {
+            throw std::invalid_argument("Invalid quantity format specification");
+         }
+      }
+
+      //! Parses a specification from [aFirst, aLast) into *this, in the style of std::from_chars.
+      //! Parsing stops at the end of the specification, which is returned in ptr.
+      //! On failure, ec is std::errc::invalid_argument and *this is unmodified.
+      constexpr std::from_chars_result parse(const char* aFirst, const char* aLast) noexcept
+      {
+         quantity_format result;
+         const char* position = aFirst;
+         if (position != aLast && *position == '.')
+         {
+            const auto [end, ec] = rgf::detail::parse_small_integer(position + 1, aLast, result.mPrecision);
+            if (ec != std::errc() || result.mPrecision < 0)
+            {
+               return { position, std::errc::invalid_argument };
+            }
+            position = end;
+         }
+
+         const std::string_view rest(position, static_cast<std::size_t>(aLast - position));
+         if (rest.starts_with("auto") && (rest.size() == 4 || !rgf::detail::is_unit_name_character(rest[4])))
+         {
+            result.mMode = mode::automatic;
+            position += 4;
+         }
+         else if (position != aLast && rgf::detail::is_unit_name_character(*position))
+         {
+            const auto [end, ec] = rgf::parse_unit(position, aLast, result.mUnit);
+            if (ec != std::errc())
+            {
+               return { end, ec };
+            }
+            result.mMode = mode::unit;
+            result.mSymbol = std::string_view(position, static_cast<std::size_t>(end - position));
+            position = end;
+         }
+         *this = result;
+         return { position, std::errc() };
+      }
+
+      //! Number of decimals in fixed notation, or -1 for the shortest exact form.
+      constexpr int precision() const noexcept
+      {
+         return mPrecision;
+      }
+      constexpr bool is_automatic() const noexcept
+      {
+         return mMode == mode::automatic;
+      }
+      //! True if quantities are written in the unit given in the specification, rather than in standard units.
+      constexpr bool has_unit() const noexcept
+      {
+         return mMode == mode::unit;
+      }
+      //! The unit given in the specification. Only meaningful if has_unit() is true.
+      constexpr const parsed_unit& unit() const noexcept
+      {
+         return mUnit;
+      }
+      constexpr std::string_view unit_symbol() const noexcept
+      {
+         return mSymbol;
+      }
+
+      //! Returns true if quantities of dimension DIM can be written in this format.
+      //! Specified units must have dimension DIM, which must be over the standard bases.
+      template<dimension_type DIM>
+      constexpr bool accepts() const noexcept
+      {
+         if (mMode != mode::unit)
+         {
+            return true;
+         }
+         if constexpr (requires { runtime_dimension<standard_system>::of<DIM>(); })
+         {
+            return mUnit.dimension == runtime_dimension<standard_system>::of<DIM>();
+         }
+         else
+         {
+            return false;
+         }
+      }
+
+   private:
+      enum class mode
+      {
+         standard,
+         automatic,
+         unit
+      };
+
+      mode mMode = mode::standard;
+      int mPrecision = -1;
+      parsed_unit mUnit;
+      std::string_view mSymbol;
+   };
+
+   namespace detail
+   {
+      //! Exact powers of ten from 10^0 to 10^22, the largest exactly representable as a double.
+      inline constexpr std::array<double, 23> exact_powers_of_ten = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9,
+         1e10, 1e11, 1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+
+      //! Returns aValue * 10^aPower for |aPower| <= 22, rounded once.
+      constexpr double scale_by_power_of_ten(double aValue, int aPower) noexcept
+      {
+         return aPower >= 0 ? aValue * exact_powers_of_ten[aPower] : aValue / exact_powers_of_ten[-aPower];
+      }
+
+      //! Returns floor(log10(aValue)) for aValue in [1e-12, 1e13), clamped to [-12, 12] outside of it.
+      //! The binary exponent is read from the representation and scaled by log10(2), which is exact or one too small,
+      //!    then corrected with a single comparison, so no logarithm is evaluated.
+      inline int decimal_exponent(double aValue) noexcept
+      {
+         constexpr std::array<double, 26> powers = { 1e-12, 1e-11, 1e-10, 1e-9, 1e-8, 1e-7, 1e-6, 1e-5, 1e-4, 1e-3, 1e-2, 1e-1,
+            1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11, 1e12, 1e13 };
+         const int binary = static_cast<int>((std::bit_cast<std::uint64_t>(aValue) >> 52) & 0x7FF) - 1023;
+         // 78913 / 2^18 is log10(2) rounded down, which is exact enough for every double exponent.
+         int decimal = (binary * 78913) >> 18;
+         decimal = decimal < -12 ? -12 : decimal > 12 ? 12 : decimal;
+         return aValue >= powers[decimal + 13] ? decimal + 1 : decimal;
+      }
+
+      //! Writes aText to [aFirst, aLast), and returns the end of it, or nullptr if it does not fit.
+      inline char* write_text(char* aFirst, char* aLast, std::string_view aText) noexcept
+      {
+         if (static_cast<std::size_t>(aLast - aFirst) < aText.size())
+         {
+            return nullptr;
+         }
+         std::memcpy(aFirst, aText.data(), aText.size());
+         return aFirst + aText.size();
+      }
+
+      //! The 'value' member of single_base is true if DIM is a single base to the first power, whose unit may take an SI prefix.
+      //! If so, 'symbol' and 'power' hold that base's dimension_base_symbol_v and dimension_base_symbol_power_v.
+      template<dimension_type DIM>
+      struct single_base
+      {
+         constexpr static bool value = false;
+      };
+      template<template<int> typename... BASE_TYPES, int... EXPONENTS>
+         requires (((EXPONENTS != 0) + ... + 0) == 1 && ((EXPONENTS == 0 || EXPONENTS == 1) && ...))
+      struct single_base<dimension_t<BASE_TYPES<EXPONENTS>...>>
+      {
+      private:
+         constexpr static std::array<int, sizeof...(EXPONENTS)> exponents = { EXPONENTS... };
+         constexpr static std::size_t index = []
+         {
+            std::size_t i = 0;
+            while (exponents[i] == 0)
+            {
+               ++i;
+            }
+            return i;
+         }();
+
+      public:
+         constexpr static bool value = true;
+         constexpr static std::string_view symbol = std::array{ rgf::dimension_base_symbol_v<BASE_TYPES>... }[index];
+         constexpr static int power = std::array{ rgf::dimension_base_symbol_power_v<BASE_TYPES>... }[index];
+      };
+
+      template<typename T>
+      std::to_chars_result write_value(char* aFirst, char* aLast, T aValue, int aPrecision) noexcept
+      {
+         if constexpr (std::is_floating_point_v<T>)
+         {
+            return aPrecision < 0 ? std::to_chars(aFirst, aLast, aValue) : std::to_chars(aFirst, aLast, aValue, std::chars_format::fixed, aPrecision);
+         }
+         else
+         {
+            return std::to_chars(aFirst, aLast, aValue);
+         }
+      }
+
+      //! Writes aStandardValue of dimension DIM, see rgf::to_chars.
+      template<dimension_type DIM, typename T>
+      std::to_chars_result format_standard_value(char* aFirst, char* aLast, T aStandardValue, const quantity_format& aFormat) noexcept
+      {
+         if (!aFormat.template accepts<DIM>())
+         {
+            return { aFirst, std::errc::invalid_argument };
+         }
+
+         // Floating point values are scaled in double and written in T, so that floats are not written with double's digits.
+         using scaled_type = std::conditional_t<std::is_floating_point_v<T>, T, double>;
+         std::to_chars_result result;
+         std::string_view prefix;
+         std::string_view symbol;
+         if (aFormat.has_unit())
+         {
+            const double value = static_cast<double>(aStandardValue) / aFormat.unit().factor;
+            result = write_value(aFirst, aLast, static_cast<scaled_type>(value), aFormat.precision());
+            symbol = aFormat.unit_symbol();
+         }
+         else if (const double value = static_cast<double>(aStandardValue);
+            single_base<DIM>::value && aFormat.is_automatic() && value != 0 && value - value == 0)
+         {
+            if constexpr (single_base<DIM>::value)
+            {
+               constexpr int power = single_base<DIM>::power;
+               const int exponent = decimal_exponent(value < 0 ? -value : value) + power;
+               int engineering = (exponent >= 0 ? exponent / 3 : -((2 - exponent) / 3)) * 3;
+               engineering = engineering < -9 ? -9 : engineering > 9 ? 9 : engineering;
+               result = write_value(aFirst, aLast, static_cast<scaled_type>(scale_by_power_of_ten(value, power - engineering)), aFormat.precision());
+               prefix = si_prefix(engineering);
+               symbol = single_base<DIM>::symbol;
+            }
+         }
+         else
+         {
+            result = write_value(aFirst, aLast, aStandardValue, aFormat.precision());
+            symbol = rgf::dimension_symbol_v<DIM>;
+         }
+         if (result.ec != std::errc())
+         {
+            return result;
+         }
+
+         char* position = result.ptr;
+         if (!symbol.empty())
+         {
+            position = write_text(position, aLast, " ");
+            position = position ? write_text(position, aLast, prefix) : nullptr;
+            position = position ? write_text(position, aLast, symbol) : nullptr;
+         }
+         if (!position)
+         {
+            return { aLast, std::errc::value_too_large };
+         }
+         return { position, std::errc() };
+      }
+   }
+
+   //! Writes aQuantity to [aFirst, aLast) as a value, a space and a unit symbol, e.g. "12.5 km/h", in the style of std::to_chars.
+   //! See quantity_format for the units and precision that may be requested. Scalars are written without a symbol.
+   //! If the buffer is too small, ec is std::errc::value_too_large and ptr is aLast.
+   //! If aFormat names a unit of a different dimension, ec is std::errc::invalid_argument and ptr is aFirst.
+   //! No memory is allocated.
+   template<dimension_type DIMENSION, arithmetic T>
+   std::to_chars_result to_chars(char* aFirst, char* aLast, const quantity<DIMENSION, T>& aQuantity,
+      const quantity_format& aFormat = quantity_format()) noexcept
+   {
+      return rgf::detail::format_standard_value<DIMENSION>(aFirst, aLast, aQuantity.get_standard(), aFormat);
+   }
+   template<dimension_type DIMENSION, arithmetic T>
+   std::to_chars_result to_chars(char* aFirst, char* aLast, const absolute<DIMENSION, T>& aAbsolute,
+      const quantity_format& aFormat = quantity_format()) noexcept
+   {
+      return rgf::detail::format_standard_value<DIMENSION>(aFirst, aLast, aAbsolute.get_standard(), aFormat);
+   }
+}
+
+#if defined(__cpp_lib_format)
+namespace rgf::detail
+{
+   //! Shared implementation of the std::formatter specializations for quantity and absolute.
+   //! The specification is parsed and checked against the dimension when the format string is, so with std::format
+   //!    an unknown or mismatched unit is a compile-time error.
+   template<dimension_type DIM>
+   struct quantity_formatter
+   {
+      constexpr auto parse(std::format_parse_context& aContext)
+      {
+         const char* first = std::to_address(aContext.begin());
+         const char* last = std::to_address(aContext.end());
+         const auto [end, ec] = mFormat.parse(first, last);
+         if (ec != std::errc() || (end != last && *end != '}'))
+         {
+            throw std::format_error("Invalid quantity format specification");
+         }
+         if (!mFormat.template accepts<DIM>())
+         {
+            throw std::format_error("Quantity format unit has the wrong dimension");
+         }
+         return aContext.begin() + (end - first);
+      }
+
+      //! Throws std::format_error, as parse does, if the value cannot be written, e.g. because the requested precision
+      //!    makes it longer than the buffer.
+      template<typename VALUE, typename CONTEXT>
+      auto format(const VALUE& aValue, CONTEXT& aContext) const
+      {
+         char buffer[128];
+         const auto [end, ec] = rgf::to_chars(buffer, buffer + sizeof(buffer), aValue, mFormat);
+         if (ec == std::errc::value_too_large)
+         {
+            throw std::format_error("Formatted quantity does not fit in the buffer");
+         }
+         if (ec != std::errc())
+         {
+            throw std::format_error("Quantity could not be formatted");
+         }
+         return std::copy(buffer, end, aContext.out());
+      }
+
+      quantity_format mFormat;
+   };
+}
+
+template<rgf::dimension_type DIMENSION, rgf::arithmetic T>
+struct std::formatter<rgf::quantity<DIMENSION, T>, char> : rgf::detail::quantity_formatter<DIMENSION>
+{};
+template<rgf::dimension_type DIMENSION, rgf::arithmetic T>
+struct std::formatter<rgf::absolute<DIMENSION, T>, char> : rgf::detail::quantity_formatter<DIMENSION>
+{};
+#endif
@@ -0,0 +1,466 @@
+#pragma once
+
+#include "Dimension.hpp"
+#include "Quantity.hpp"
+#include "QuantityArray.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cassert>
+#include <cmath>
+#include <concepts>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+namespace rgf
+{
+   namespace detail
+   {
+      //! Number of values stored for N elements of type T.
+      //! Small vectors are padded to a power of two, so that e.g. a 3-vector of doubles fills one 256-bit register.
+      template<typename T, std::size_t N>
+      constexpr std::size_t padded_size_v = std::bit_ceil(N) * sizeof(T) <= 64 ? std::bit_ceil(N) : N;
+
+      //! Alignment of padded_size_v<T, N> values. Padded vectors are aligned to their size, so they load with one instruction.
+      //! Larger vectors are aligned to a cache line, which is as much as any load needs.
+      template<typename T, std::size_t N>
+      constexpr std::size_t padded_alignment_v = padded_size_v<T, N> != N || std::has_single_bit(N * sizeof(T))
+         ? std::max(std::min<std::size_t>(padded_size_v<T, N> * sizeof(T), 64), alignof(T))
+         : alignof(T);
+   }
+
+   template<dimension_type MATRIX_DIMENSION, std::size_t ROWS, std::size_t COLUMNS, arithmetic MATRIX_VALUE_TYPE = double>
+   class quantity_mat;
+
+   //! quantity_vec<DIMENSION, N, VALUE_TYPE> is a vector of N quantities with the same dimension, such as a position or a force.
+   //! Values are stored in standard units and padded, so element-wise operations on a 3-vector compile to single SIMD
+   //!    instructions. Padding values take part in element-wise operations, but never in results. They are zeroed again
+   //!    after multiplications and divisions, which turn them into NaN when scaling by an infinity or dividing by zero.
+   //! Products derive their dimensions like quantity's operators: dot of a length and a force vector is an energy,
+   //!    and cross of a length and a force vector is a torque.
+   template<dimension_type VECTOR_DIMENSION, std::size_t N, arithmetic VECTOR_VALUE_TYPE = double>
+   class alignas(rgf::detail::padded_alignment_v<VECTOR_VALUE_TYPE, N>) quantity_vec
+   {
+   public:
+      using dimension = VECTOR_DIMENSION;
+      using value_type = VECTOR_VALUE_TYPE;
+      using size_type = std::size_t;
+
+      using quantity_type = quantity<dimension, value_type>;
+      using reference = quantity_reference<dimension, value_type>;
+
+      constexpr static size_type padded_size = rgf::detail::padded_size_v<value_type, N>;
+
+      //! When default-constructed, every element is value-initialized.
+      constexpr quantity_vec() noexcept = default;
+
+      //! Constructs a vector from its N elements.
+      template<std::convertible_to<quantity_type>... QUANTITIES>
+         requires (sizeof...(QUANTITIES) == N)
+      constexpr quantity_vec(const QUANTITIES&... aQuantities) noexcept
+         : mValues{ quantity_type(aQuantities).get_standard()... }
+      {}
+
+      //! Returns the number of elements, which excludes padding.
+      constexpr static size_type size() noexcept
+      {
+         return N;
+      }
+
+      //! Element access.
+      //! Overload 1 returns the element by value.
+      //! Overload 2 returns a quantity_reference, through which the element may be assigned.
+      constexpr quantity_type operator[](size_type aIndex) const noexcept
+      {
+         assert(aIndex < N);
+         return { std::in_place, mValues[aIndex] };
+      }
+      constexpr reference operator[](size_type aIndex) noexcept
+      {
+         assert(aIndex < N);
+         return reference(mValues[aIndex]);
+      }
+
+      //! Direct access to the underlying values in standard units, excluding padding.
+      //! Generally not necessary. Use other APIs when possible.
+      constexpr std::span<const value_type, N> values() const noexcept
+      {
+         return std::span<const value_type, N>(mValues, N);
+      }
+      constexpr std::span<value_type, N> values() noexcept
+      {
+         return std::span<value_type, N>(mValues, N);
+      }
+
+      //! Element-wise in-place operators.
+      constexpr quantity_vec& operator+=(const quantity_vec& aOther) noexcept
+      {
+         for (size_type i = 0; i < padded_size; ++i)
+         {
+            mValues[i] += aOther.mValues[i];
+         }
+         return *this;
+      }
+      constexpr quantity_vec& operator-=(const quantity_vec& aOther) noexcept
+      {
+         for (size_type i = 0; i < padded_size; ++i)
+         {
+            mValues[i] -= aOther.mValues[i];
+         }
+         return *this;
+      }
+      constexpr quantity_vec& operator*=(value_type aValue) noexcept
+      {
+         for (size_type i = 0; i < padded_size; ++i)
+         {
+            mValues[i] *= aValue;
+         }
+         clear_padding();
+         return *this;
+      }
+      constexpr quantity_vec& operator/=(value_type aValue) noexcept
+      {
+         for (size_type i = 0; i < padded_size; ++i)
+         {
+            mValues[i] /= aValue;
+         }
+         clear_padding();
+         return *this;
+      }
+
+      //! Element-wise addition, subtraction and negation.
+      constexpr friend quantity_vec operator+(quantity_vec aLeft, const quantity_vec& aRight) noexcept
+      {
+         return aLeft += aRight;
+      }
+      constexpr friend quantity_vec operator-(quantity_vec aLeft, const quantity_vec& aRight) noexcept
+      {
+         return aLeft -= aRight;
+      }
+      constexpr quantity_vec operator-() const noexcept
+      {
+         quantity_vec result;
+         for (size_type i = 0; i < padded_size; ++i)
+         {
+            result.mValues[i] = -mValues[i];
+         }
+         return result;
+      }
+
+      //! Multiplication by a quantity scales every element, and multiplies the dimensions.
+      //! E.g. a velocity vector multiplied by a time is a displacement vector.
+      template<dimension_type RDIM, arithmetic T>
+      constexpr friend quantity_vec<dimension_product_t<dimension, RDIM>, N, product_t<value_type, T>>
+         operator*(const quantity_vec& aLeft, const quantity<RDIM, T>& aRight) noexcept
+      {
+         return quantity_vec::transform<dimension_product_t<dimension, RDIM>>(aLeft,
+            [aRight](value_type aValue) { return aValue * aRight.get_standard(); });
+      }
+      template<dimension_type LDIM, arithmetic T>
+      constexpr friend quantity_vec<dimension_product_t<LDIM, dimension>, N, product_t<T, value_type>>
+         operator*(const quantity<LDIM, T>& aLeft, const quantity_vec& aRight) noexcept
+      {
+         return quantity_vec::transform<dimension_product_t<LDIM, dimension>>(aRight,
+            [aLeft](value_type aValue) { return aLeft.get_standard() * aValue; });
+      }
+      template<dimension_type RDIM, arithmetic T>
+      constexpr friend quantity_vec<dimension_quotient_t<dimension, RDIM>, N, quotient_t<value_type, T>>
+         operator/(const quantity_vec& aLeft, const quantity<RDIM, T>& aRight) noexcept
+      {
+         return quantity_vec::transform<dimension_quotient_t<dimension, RDIM>>(aLeft,
+            [aRight](value_type aValue) { return aValue / aRight.get_standard(); });
+      }
+
+      //! Multiplication and division by plain values, which keep the dimension.
+      constexpr friend quantity_vec operator*(quantity_vec aLeft, value_type aRight) noexcept
+      {
+         return aLeft *= aRight;
+      }
+      constexpr friend quantity_vec operator*(value_type aLeft, quantity_vec aRight) noexcept
+      {
+         return aRight *= aLeft;
+      }
+      constexpr friend quantity_vec operator/(quantity_vec aLeft, value_type aRight) noexcept
+      {
+         return aLeft /= aRight;
+      }
+
+      //! Comparison operators compare the elements, excluding padding.
+      constexpr friend bool operator==(const quantity_vec& aLeft, const quantity_vec& aRight) noexcept
+      {
+         for (size_type i = 0; i < N; ++i)
+         {
+            if (aLeft.mValues[i] != aRight.mValues[i])
+            {
+               return false;
+            }
+         }
+         return true;
+      }
+
+   private:
+      template<dimension_type, std::size_t, arithmetic>
+      friend class quantity_vec;
+      template<dimension_type, std::size_t, std::size_t, arithmetic>
+      friend class quantity_mat;
+
+      //! Returns a vector of aOperation applied to every value of aVector, including padding, whose padding is then zeroed.
+      template<dimension_type RESULT_DIMENSION, typename OPERATION>
+      constexpr static auto transform(const quantity_vec& aVector, OPERATION aOperation) noexcept
+      {
+         using result_value_type = decltype(aOperation(value_type()));
+         quantity_vec<RESULT_DIMENSION, N, result_value_type> result;
+         for (size_type i = 0; i < padded_size; ++i)
+         {
+            result.mValues[i] = aOperation(aVector.mValues[i]);
+         }
+         result.clear_padding();
+         return result;
+      }
+
+      //! Sets the padding values to zero.
+      constexpr void clear_padding() noexcept
+      {
+         for (size_type i = N; i < padded_size; ++i)
+         {
+            mValues[i] = value_type();
+         }
+      }
+
+      value_type mValues[padded_size]{};
+   };
+
+   //! Returns the dot product of aLeft and aRight, whose dimension is the product of theirs.
+   template<dimension_type LDIM, dimension_type RDIM, std::size_t N, arithmetic T>
+   constexpr quantity<dimension_product_t<LDIM, RDIM>, T> dot(const quantity_vec<LDIM, N, T>& aLeft, const quantity_vec<RDIM, N, T>& aRight) noexcept
+   {
+      const auto left = aLeft.values();
+      const auto right = aRight.values();
+      T result = left[0] * right[0];
+      for (std::size_t i = 1; i < N; ++i)
+      {
+         result += left[i] * right[i];
+      }
+      return { std::in_place, result };
+   }
+
+   //! Returns the cross product of two 3-vectors, whose dimension is the product of theirs.
+   //! E.g. the cross product of a lever arm and a force is a torque.
+   template<dimension_type LDIM, dimension_type RDIM, arithmetic T>
+   constexpr quantity_vec<dimension_product_t<LDIM, RDIM>, 3, T> cross(const quantity_vec<LDIM, 3, T>& aLeft, const quantity_vec<RDIM, 3, T>& aRight) noexcept
+   {
+      return { aLeft[1] * aRight[2] - aLeft[2] * aRight[1],
+               aLeft[2] * aRight[0] - aLeft[0] * aRight[2],
+               aLeft[0] * aRight[1] - aLeft[1] * aRight[0] };
+   }
+
+   //! Returns the squared Euclidean norm of aVector, which has the square of its dimension.
+   template<dimension_type DIMENSION, std::size_t N, arithmetic T>
+   constexpr auto squared_norm(const quantity_vec<DIMENSION, N, T>& aVector) noexcept
+   {
+      return rgf::dot(aVector, aVector);
+   }
+
+   //! Returns the Euclidean norm of aVector, which has its dimension.
+   template<dimension_type DIMENSION, std::size_t N, std::floating_point T>
+   quantity<DIMENSION, T> norm(const quantity_vec<DIMENSION, N, T>& aVector) noexcept
+   {
+      return { std::in_place, std::sqrt(rgf::squared_norm(aVector).get_standard()) };
+   }
+
+   //! Returns aVector divided by its norm, which is a dimensionless unit vector.
+   template<dimension_type DIMENSION, std::size_t N, std::floating_point T>
+   auto normalized(const quantity_vec<DIMENSION, N, T>& aVector) noexcept
+   {
+      return aVector / rgf::norm(aVector);
+   }
+
+   //! quantity_mat<DIMENSION, ROWS, COLUMNS, VALUE_TYPE> is a matrix of quantities with the same dimension,
+   //!    such as a dimensionless rotation or an inertia tensor.
+   //! Values are stored in standard units as padded columns, so a matrix-vector product is one multiply-add of a column
+   //!    per element of the vector, each a single SIMD instruction for 3x3 matrices.
+   //! Products derive their dimensions like quantity's operators, e.g. an inertia tensor times an angular velocity
+   //!    vector is an angular momentum vector.
+   template<dimension_type MATRIX_DIMENSION, std::size_t ROWS, std::size_t COLUMNS, arithmetic MATRIX_VALUE_TYPE>
+   class quantity_mat
+   {
+   public:
+      using dimension = MATRIX_DIMENSION;
+      using value_type = MATRIX_VALUE_TYPE;
+      using size_type = std::size_t;
+
+      using quantity_type = quantity<dimension, value_type>;
+      using reference = quantity_reference<dimension, value_type>;
+      using column_type = quantity_vec<dimension, ROWS, value_type>;
+
+      //! When default-constructed, every element is value-initialized.
+      constexpr quantity_mat() noexcept = default;
+
+      //! Constructs a matrix from its COLUMNS columns.
+      template<std::convertible_to<column_type>... COLUMN_TYPES>
+         requires (sizeof...(COLUMN_TYPES) == COLUMNS)
+      constexpr explicit quantity_mat(const COLUMN_TYPES&... aColumns) noexcept
+         : mColumns{ column_type(aColumns)... }
+      {}
+
+      constexpr static size_type rows() noexcept
+      {
+         return ROWS;
+      }
+      constexpr static size_type columns() noexcept
+      {
+         return COLUMNS;
+      }
+
+      //! Element access.
+      //! Overload 1 returns the element by value.
+      //! Overload 2 returns a quantity_reference, through which the element may be assigned.
+      constexpr quantity_type operator()(size_type aRow, size_type aColumn) const noexcept
+      {
+         assert(aColumn < COLUMNS);
+         return mColumns[aColumn][aRow];
+      }
+      constexpr reference operator()(size_type aRow, size_type aColumn) noexcept
+      {
+         assert(aColumn < COLUMNS);
+         return mColumns[aColumn][aRow];
+      }
+
+      //! Column access.
+      constexpr const column_type& column(size_type aColumn) const noexcept
+      {
+         assert(aColumn < COLUMNS);
+         return mColumns[aColumn];
+      }
+      constexpr column_type& column(size_type aColumn) noexcept
+      {
+         assert(aColumn < COLUMNS);
+         return mColumns[aColumn];
+      }
+
+      //! Element-wise in-place operators.
+      constexpr quantity_mat& operator+=(const quantity_mat& aOther) noexcept
+      {
+         for (size_type c = 0; c < COLUMNS; ++c)
+         {
+            mColumns[c] += aOther.mColumns[c];
+         }
+         return *this;
+      }
+      constexpr quantity_mat& operator-=(const quantity_mat& aOther) noexcept
+      {
+         for (size_type c = 0; c < COLUMNS; ++c)
+         {
+            mColumns[c] -= aOther.mColumns[c];
+         }
+         return *this;
+      }
+      constexpr quantity_mat& operator*=(value_type aValue) noexcept
+      {
+         for (size_type c = 0; c < COLUMNS; ++c)
+         {
+            mColumns[c] *= aValue;
+         }
+         return *this;
+      }
+
+      constexpr friend quantity_mat operator+(quantity_mat aLeft, const quantity_mat& aRight) noexcept
+      {
+         return aLeft += aRight;
+      }
+      constexpr friend quantity_mat operator-(quantity_mat aLeft, const quantity_mat& aRight) noexcept
+      {
+         return aLeft -= aRight;
+      }
+      constexpr friend quantity_mat operator*(quantity_mat aLeft, value_type aRight) noexcept
+      {
+         return aLeft *= aRight;
+      }
+      constexpr friend quantity_mat operator*(value_type aLeft, quantity_mat aRight) noexcept
+      {
+         return aRight *= aLeft;
+      }
+
+      //! Matrix-vector product, whose dimension is the product of the matrix's and the vector's.
+      //! The result is the sum of the columns, each scaled by an element of the vector.
+      template<dimension_type RDIM>
+      constexpr friend quantity_vec<dimension_product_t<dimension, RDIM>, ROWS, value_type>
+         operator*(const quantity_mat& aLeft, const quantity_vec<RDIM, COLUMNS, value_type>& aRight) noexcept
+      {
+         return quantity_mat::multiply<dimension_product_t<dimension, RDIM>>(aLeft, aRight);
+      }
+
+      //! Matrix product, whose dimension is the product of the matrices'.
+      template<dimension_type RDIM, std::size_t RCOLUMNS>
+      constexpr friend quantity_mat<dimension_product_t<dimension, RDIM>, ROWS, RCOLUMNS, value_type>
+         operator*(const quantity_mat& aLeft, const quantity_mat<RDIM, COLUMNS, RCOLUMNS, value_type>& aRight) noexcept
+      {
+         quantity_mat<dimension_product_t<dimension, RDIM>, ROWS, RCOLUMNS, value_type> result;
+         for (size_type c = 0; c < RCOLUMNS; ++c)
+         {
+            result.column(c) = aLeft * aRight.column(c);
+         }
+         return result;
+      }
+
+      //! Comparison operators compare the elements, excluding padding.
+      constexpr friend bool operator==(const quantity_mat& aLeft, const quantity_mat& aRight) noexcept
+      {
+         for (size_type c = 0; c < COLUMNS; ++c)
+         {
+            if (!(aLeft.mColumns[c] == aRight.mColumns[c]))
+            {
+               return false;
+            }
+         }
+         return true;
+      }
+
+   private:
+      //! Returns the sum of the columns of aMatrix, each scaled by the corresponding element of aVector.
+      template<dimension_type RESULT_DIMENSION, dimension_type RDIM>
+      constexpr static quantity_vec<RESULT_DIMENSION, ROWS, value_type>
+         multiply(const quantity_mat& aMatrix, const quantity_vec<RDIM, COLUMNS, value_type>& aVector) noexcept
+      {
+         quantity_vec<RESULT_DIMENSION, ROWS, value_type> result;
+         const auto addColumn = [&result, &aMatrix, &aVector](size_type aColumn)
+         {
+            for (size_type i = 0; i < column_type::padded_size; ++i)
+            {
+               result.mValues[i] += aMatrix.mColumns[aColumn].mValues[i] * aVector.mValues[aColumn];
+            }
+         };
+         // The columns are unrolled, since compilers would otherwise vectorize across them rather than along them.
+         [&addColumn]<size_type... COLUMN_INDICES>(std::index_sequence<COLUMN_INDICES...>)
+         {
+            (addColumn(COLUMN_INDICES), ...);
+         }(std::make_index_sequence<COLUMNS>());
+         result.clear_padding();
+         return result;
+      }
+
+      column_type mColumns[COLUMNS]{};
+   };
+
+   //! Returns the transpose of aMatrix.
+   template<dimension_type DIMENSION, std::size_t ROWS, std::size_t COLUMNS, arithmetic T>
+   constexpr quantity_mat<DIMENSION, COLUMNS, ROWS, T> transpose(const quantity_mat<DIMENSION, ROWS, COLUMNS, T>& aMatrix) noexcept
+   {
+      quantity_mat<DIMENSION, COLUMNS, ROWS, T> result;
+      for (std::size_t r = 0; r < ROWS; ++r)
+      {
+         for (std::size_t c = 0; c < COLUMNS; ++c)
+         {
+            result(c, r) = aMatrix(r, c);
+         }
+      }
+      return result;
+   }
+
+   //! A 3-vector of doubles occupies exactly one 256-bit register.
+   static_assert(sizeof(quantity_vec<dimension_t<>, 3, double>) == 32 && alignof(quantity_vec<dimension_t<>, 3, double>) == 32);
+   static_assert(sizeof(quantity_vec<dimension_t<>, 3, float>) == 16 && alignof(quantity_vec<dimension_t<>, 3, float>) == 16);
+   static_assert(sizeof(quantity_mat<dimension_t<>, 3, 3, double>) == 96);
+}
@@ -0,0 +1,205 @@
+#pragma once
+
+#include "CommonDimensions.hpp"
+#include "Dimension.hpp"
+#include "Quantity.hpp"
+#include "ShardedAccumulator.hpp"
+
+#include <algorithm>
+#include <cassert>
+#include <chrono>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+namespace rgf
+{
+   namespace detail
+   {
+      //! Converts a std::chrono duration to a time quantity in seconds.
+      template<typename REP, typename PERIOD>
+      constexpr time_quantity to_time_quantity(std::chrono::duration<REP, PERIOD> aDuration) noexcept
+      {
+         return { std::in_place, std::chrono::duration<double>(aDuration).count() };
+      }
+   }
+
+   //! rate_meter<quantity<DIMENSION, VALUE_TYPE>, CLOCK> measures how fast an amount accumulates, e.g. the throughput of
+   //!    a connection, as a quantity of DIMENSION per time. Meters of data_quantity report data / time, such as
+   //!    rgf::megabytes / rgf::seconds, and meters of events (event_rate_meter) report frequencies, such as rgf::hertz.
+   //! record() may be called from any number of threads. It adds to a sharded_accumulator, so it never locks or
+   //!    contends with other threads, and it never reads the clock.
+   //! Rates are read in three ways:
+   //!    windowed_rate()  The amount recorded in the last window, divided by the time it was recorded over. The window
+   //!                     is divided into buckets, and expires one bucket at a time.
+   //!    ewma_rate()      An exponentially weighted moving average of the rate, which weights the rate over the last
+   //!                     time constant by 1 - 1/e. It starts from zero, like a load average.
+   //!    mean_rate()      The total amount divided by the time since the meter was constructed.
+   //! Amounts are attributed to the time at which they are collected by update() or one of the readers, so one of them
+   //!    should be called at least once per bucket. Readers and update() lock a mutex, which record() never touches.
+   //! E.g.
+   //!    rgf::rate_meter<rgf::data_quantity_t<std::int64_t>> meter(rgf::seconds(10));
+   //!    meter.record(rgf::data_quantity_t<std::int64_t>(std::in_place, bytesSent));
+   //!    double rate = meter.windowed_rate().get(rgf::megabytes / rgf::seconds);
+   template<typename QUANTITY, typename CLOCK = std::chrono::steady_clock>
+   class rate_meter;
+
+   template<dimension_type DIMENSION, arithmetic VALUE_TYPE, typename CLOCK>
+   class rate_meter<quantity<DIMENSION, VALUE_TYPE>, CLOCK>
+   {
+   public:
+      using dimension = DIMENSION;
+      using value_type = VALUE_TYPE;
+
+      using amount_type = quantity<dimension, value_type>;
+      using rate_type = quantity<dimension_quotient_t<dimension, time_dimension>, double>;
+
+      using clock = CLOCK;
+      using time_point = typename clock::time_point;
+      using duration = typename clock::duration;
+
+      //! Constructs a meter whose window is aWindow long, divided into aBucketCount buckets.
+      //! The moving average has time constant aTimeConstant, which defaults to the window.
+      explicit rate_meter(time_quantity aWindow, std::size_t aBucketCount = 60, time_point aStart = clock::now())
+         : rate_meter(aWindow, aBucketCount, aWindow, aStart)
+      {}
+      rate_meter(time_quantity aWindow, std::size_t aBucketCount, time_quantity aTimeConstant, time_point aStart = clock::now())
+         : mBuckets(std::max<std::size_t>(aBucketCount, 1), bucket{ amount_type(), aStart })
+         , mBucketDuration(std::max(std::chrono::duration_cast<duration>(
+            std::chrono::duration<double>(aWindow.get_standard() / static_cast<double>(mBuckets.size()))), duration(1)))
+         , mTimeConstant(aTimeConstant.get_standard())
+         , mStart(aStart)
+         , mBucketStart(aStart)
+         , mLastUpdate(aStart)
+      {
+         assert(aWindow.get_standard() > 0 && aTimeConstant.get_standard() > 0);
+      }
+
+      rate_meter(const rate_meter&) = delete;
+      rate_meter& operator=(const rate_meter&) = delete;
+
+      //! Records aAmount. Lock-free, and safe to call from any thread.
+      void record(const amount_type& aAmount) noexcept
+      {
+         mPending.add(aAmount);
+      }
+      //! Records a single event. Only available to scalar meters, see event_rate_meter.
+      void record() noexcept requires amount_type::is_scalar
+      {
+         mPending.add(amount_type(1));
+      }
+
+      //! Collects the amounts recorded since the last update, attributes them to aNow, and expires old buckets.
+      //! aNow must not be earlier than the time of the previous update.
+      void update(time_point aNow = clock::now())
+      {
+         const std::lock_guard lock(mMutex);
+         collect(aNow);
+      }
+
+      //! Returns the amount recorded since the meter was constructed, including amounts not collected yet.
+      //! While another thread is collecting, the amounts it is moving may be briefly missing from the result.
+      amount_type total() const noexcept
+      {
+         return amount_type(mTotal.load(std::memory_order_relaxed) + mPending.snapshot());
+      }
+
+      //! Returns the amount in the buckets of the window up to aNow, divided by the time over which it was recorded.
+      //! That time starts at the last collection before the oldest bucket, since amounts are recorded before they are
+      //!    collected, so it is about one window long when updates come at least once per bucket.
+      rate_type windowed_rate(time_point aNow = clock::now())
+      {
+         const std::lock_guard lock(mMutex);
+         collect(aNow);
+         amount_type amount;
+         for (const bucket& entry : mBuckets)
+         {
+            amount += entry.mAmount;
+         }
+         const bucket& oldest = mBuckets[(mCurrentBucket + 1) % mBuckets.size()];
+         return rate(amount, std::min(aNow - oldest.mRecordedSince, aNow - mStart));
+      }
+      //! Returns the exponentially weighted moving average of the rate up to aNow.
+      rate_type ewma_rate(time_point aNow = clock::now())
+      {
+         const std::lock_guard lock(mMutex);
+         collect(aNow);
+         return mAverage;
+      }
+      //! Returns the total amount divided by the time from construction to aNow.
+      rate_type mean_rate(time_point aNow = clock::now())
+      {
+         const std::lock_guard lock(mMutex);
+         collect(aNow);
+         return rate(mTotal.load(std::memory_order_relaxed), aNow - mStart);
+      }
+
+   private:
+      //! Returns aAmount / aElapsed, or zero if no time has elapsed.
+      static rate_type rate(const amount_type& aAmount, duration aElapsed) noexcept
+      {
+         if (aElapsed <= duration::zero())
+         {
+            return rate_type();
+         }
+         return quantity<dimension, double>(aAmount) / rgf::detail::to_time_quantity(aElapsed);
+      }
+
+      void collect(time_point aNow)
+      {
+         assert(aNow >= mLastUpdate);
+         const amount_type amount = mPending.snapshot_and_reset();
+         mTotal.fetch_add(amount, std::memory_order_relaxed);
+
+         // Expires the buckets that ended before aNow, at most once around the ring.
+         // The amounts collected into a new bucket were recorded since the previous collection, which is mLastUpdate.
+         const std::int64_t elapsedBuckets = (aNow - mBucketStart) / mBucketDuration;
+         const std::size_t expired = static_cast<std::size_t>(std::min<std::int64_t>(elapsedBuckets, static_cast<std::int64_t>(mBuckets.size())));
+         for (std::size_t i = 0; i < expired; ++i)
+         {
+            mCurrentBucket = (mCurrentBucket + 1) % mBuckets.size();
+            mBuckets[mCurrentBucket] = bucket{ amount_type(), mLastUpdate };
+         }
+         mBucketStart += mBucketDuration * elapsedBuckets;
+         mBuckets[mCurrentBucket].mAmount += amount;
+
+         // Amounts collected with no elapsed time are held until time has passed, rather than dividing by zero.
+         mUnaveraged += amount;
+         const double elapsed = std::chrono::duration<double>(aNow - mLastUpdate).count();
+         if (elapsed > 0)
+         {
+            const double weight = -std::expm1(-elapsed / mTimeConstant);
+            mAverage += weight * (rate(mUnaveraged, aNow - mLastUpdate) - mAverage);
+            mUnaveraged = amount_type();
+            mLastUpdate = aNow;
+         }
+      }
+
+      //! The amounts collected while a bucket was current, and the time of the collection before the first of them.
+      struct bucket
+      {
+         amount_type mAmount;
+         time_point mRecordedSince;
+      };
+
+      sharded_accumulator<amount_type> mPending;
+      atomic_quantity<dimension, value_type> mTotal;
+
+      std::mutex mMutex;
+      std::vector<bucket> mBuckets;
+      duration mBucketDuration;
+      double mTimeConstant;
+      time_point mStart;
+      time_point mBucketStart;
+      time_point mLastUpdate;
+      std::size_t mCurrentBucket = 0;
+      amount_type mUnaveraged;
+      rate_type mAverage;
+   };
+
+   //! Counts events and reports their rate as a frequency_quantity.
+   template<typename CLOCK = std::chrono::steady_clock>
+   using event_rate_meter = rate_meter<scalar_quantity_t<std::int64_t>, CLOCK>;
+}
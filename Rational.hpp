@@ -0,0 +1,75 @@
+#pragma once
+
+#include <concepts>
+#include <numeric>
+#include <utility>
+
+namespace rgf
+{
+   //! rational<T> is an exact fraction of two integers, always stored in lowest terms with a positive denominator.
+   //! It is used as the conversion factor of units whose value_type is integral.
+   //! Products and quotients cancel common factors before multiplying, to delay overflow as long as possible.
+   template<std::integral T>
+   class rational
+   {
+   public:
+      using value_type = T;
+
+      constexpr rational() noexcept = default;
+
+      //! Integers are implicitly convertible to rationals.
+      constexpr rational(value_type aNumerator) noexcept
+         : mNumerator(aNumerator)
+      {}
+
+      //! Constructs the fraction aNumerator / aDenominator, reduced to lowest terms.
+      //! aDenominator must not be zero.
+      constexpr rational(value_type aNumerator, value_type aDenominator) noexcept
+      {
+         const value_type divisor = std::gcd(aNumerator, aDenominator) * (aDenominator < 0 ? -1 : 1);
+         mNumerator = aNumerator / divisor;
+         mDenominator = aDenominator / divisor;
+      }
+
+      constexpr value_type num() const noexcept
+      {
+         return mNumerator;
+      }
+      constexpr value_type den() const noexcept
+      {
+         return mDenominator;
+      }
+
+      //! Explicitly convertible to floating point types.
+      template<std::floating_point F>
+      constexpr explicit operator F() const noexcept
+      {
+         return static_cast<F>(mNumerator) / static_cast<F>(mDenominator);
+      }
+
+      constexpr friend rational operator*(const rational& aLeft, const rational& aRight) noexcept
+      {
+         const value_type leftGcd = std::gcd(aLeft.mNumerator, aRight.mDenominator);
+         const value_type rightGcd = std::gcd(aRight.mNumerator, aLeft.mDenominator);
+         return rational(std::in_place,
+            (aLeft.mNumerator / leftGcd) * (aRight.mNumerator / rightGcd),
+            (aLeft.mDenominator / rightGcd) * (aRight.mDenominator / leftGcd));
+      }
+      constexpr friend rational operator/(const rational& aLeft, const rational& aRight) noexcept
+      {
+         return aLeft * rational(aRight.mDenominator, aRight.mNumerator);
+      }
+
+      constexpr friend bool operator==(const rational& aLeft, const rational& aRight) noexcept = default;
+
+   private:
+      //! Constructs a rational that is already in lowest terms.
+      constexpr rational(std::in_place_t, value_type aNumerator, value_type aDenominator) noexcept
+         : mNumerator(aNumerator)
+         , mDenominator(aDenominator)
+      {}
+
+      value_type mNumerator = 0;
+      value_type mDenominator = 1;
+   };
+}
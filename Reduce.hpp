@@ -0,0 +1,304 @@
+#pragma once
+
+#include "Dimension.hpp"
+#include "Quantity.hpp"
+#include "QuantityArray.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <span>
+#include <type_traits>
+#include <utility>
+
+//! Reductions over contiguous ranges of quantities: sum, mean, min, max, dot and sum_of_squares.
+//! Result dimensions follow the quantity operators, e.g. dot of a length and a force range is an energy,
+//!    and sum_of_squares of a length range is an area.
+//! Loops are split over independent lanes, so compilers vectorize them without reassociating floating point operations.
+//! ParallelReduce.hpp adds overloads that take a standard execution policy.
+//! Compensated summation is defeated by -ffast-math and similar flags, which allow the compiler to cancel the compensation.
+namespace rgf
+{
+   //! Summation algorithm for floating point reductions. Integral values are always summed exactly.
+   //!    pairwise  Sums halves recursively. The error grows with log(n) rather than n, at the speed of a naive loop.
+   //!    kahan     Kahan compensated summation. The error is independent of n while terms are of similar magnitude.
+   //!    neumaier  Neumaier's variant of Kahan summation, which also stays accurate when a term is larger than the running sum.
+   //! The compensated algorithms are roughly four times as expensive as pairwise summation.
+   enum class summation
+   {
+      pairwise,
+      kahan,
+      neumaier
+   };
+
+   namespace detail
+   {
+      //! The 'dimension' and 'value_type' members of quantity_range_traits describe a contiguous range of quantities.
+      template<typename RANGE>
+      struct quantity_range_traits;
+      template<dimension_type DIMENSION, typename ELEMENT_TYPE>
+      struct quantity_range_traits<quantity_span<DIMENSION, ELEMENT_TYPE>>
+      {
+         using dimension = DIMENSION;
+         using value_type = std::remove_const_t<ELEMENT_TYPE>;
+      };
+      template<dimension_type DIMENSION, arithmetic VALUE_TYPE>
+      struct quantity_range_traits<quantity_array<DIMENSION, VALUE_TYPE>>
+      {
+         using dimension = DIMENSION;
+         using value_type = VALUE_TYPE;
+      };
+   }
+
+   //! Concept satisfied by quantity_span and quantity_array, whose values are stored contiguously in standard units.
+   template<typename RANGE>
+   concept contiguous_quantity_range = requires { typename rgf::detail::quantity_range_traits<std::remove_cvref_t<RANGE>>::dimension; };
+
+   namespace detail
+   {
+      template<typename RANGE>
+      using range_dimension_t = typename quantity_range_traits<std::remove_cvref_t<RANGE>>::dimension;
+      template<typename RANGE>
+      using range_value_t = typename quantity_range_traits<std::remove_cvref_t<RANGE>>::value_type;
+
+      template<typename RANGE>
+      std::span<const range_value_t<RANGE>> range_values(const RANGE& aRange) noexcept
+      {
+         return { aRange.data(), aRange.size() };
+      }
+
+      //! Number of independent accumulators in reduction loops.
+      //! Eight doubles fill an AVX-512 register, or two AVX registers, which hides the latency of the additions.
+      inline constexpr std::size_t reduction_lanes = 8;
+      //! Ranges up to this size are summed directly by pairwise summation, and larger ones are halved.
+      inline constexpr std::size_t pairwise_block_size = 256;
+
+      //! A sum and the rounding error accumulated while computing it. The sum's value is sum + correction.
+      template<typename T>
+      struct compensated_sum
+      {
+         T sum = T();
+         T correction = T();
+
+         //! Adds aValue with Neumaier's compensation.
+         constexpr void add(T aValue) noexcept
+         {
+            const T total = sum + aValue;
+            if constexpr (std::is_floating_point_v<T>)
+            {
+               correction += (sum < 0 ? -sum : sum) >= (aValue < 0 ? -aValue : aValue) ? (sum - total) + aValue : (aValue - total) + sum;
+            }
+            sum = total;
+         }
+         constexpr void add(const compensated_sum& aOther) noexcept
+         {
+            add(aOther.sum);
+            correction += aOther.correction;
+         }
+         constexpr T value() const noexcept
+         {
+            return sum + correction;
+         }
+      };
+
+      //! Sums aLoad(i) for i in [aFirst, aLast) in reduction_lanes independent lanes, and adds the lanes pairwise.
+      template<typename T, typename LOAD>
+      T lane_sum(std::size_t aFirst, std::size_t aLast, LOAD& aLoad) noexcept
+      {
+         std::array<T, reduction_lanes> lanes{};
+         std::size_t i = aFirst;
+         for (; i + reduction_lanes <= aLast; i += reduction_lanes)
+         {
+            for (std::size_t lane = 0; lane < reduction_lanes; ++lane)
+            {
+               lanes[lane] += aLoad(i + lane);
+            }
+         }
+         for (std::size_t lane = 0; i < aLast; ++i, ++lane)
+         {
+            lanes[lane] += aLoad(i);
+         }
+         for (std::size_t width = reduction_lanes / 2; width > 0; width /= 2)
+         {
+            for (std::size_t lane = 0; lane < width; ++lane)
+            {
+               lanes[lane] += lanes[lane + width];
+            }
+         }
+         return lanes[0];
+      }
+
+      template<typename T, typename LOAD>
+      T pairwise_sum(std::size_t aFirst, std::size_t aLast, LOAD& aLoad) noexcept
+      {
+         if (aLast - aFirst <= pairwise_block_size)
+         {
+            return lane_sum<T>(aFirst, aLast, aLoad);
+         }
+         // Split on a multiple of the block size, so that every block but the last is full.
+         const std::size_t blocks = (aLast - aFirst + pairwise_block_size - 1) / pairwise_block_size;
+         const std::size_t middle = aFirst + blocks / 2 * pairwise_block_size;
+         return pairwise_sum<T>(aFirst, middle, aLoad) + pairwise_sum<T>(middle, aLast, aLoad);
+      }
+
+      //! Kahan (if KAHAN) or Neumaier summation, in reduction_lanes independent lanes.
+      template<bool KAHAN, typename T, typename LOAD>
+      compensated_sum<T> compensated_lane_sum(std::size_t aFirst, std::size_t aLast, LOAD& aLoad) noexcept
+      {
+         std::array<T, reduction_lanes> sums{};
+         std::array<T, reduction_lanes> corrections{};
+         const auto step = [](T& aSum, T& aCorrection, T aValue)
+         {
+            if constexpr (KAHAN)
+            {
+               // aCorrection holds the negated error, as in Kahan's formulation.
+               const T value = aValue - aCorrection;
+               const T total = aSum + value;
+               aCorrection = (total - aSum) - value;
+               aSum = total;
+            }
+            else
+            {
+               const T total = aSum + aValue;
+               aCorrection += (aSum < 0 ? -aSum : aSum) >= (aValue < 0 ? -aValue : aValue) ? (aSum - total) + aValue : (aValue - total) + aSum;
+               aSum = total;
+            }
+         };
+
+         std::size_t i = aFirst;
+         for (; i + reduction_lanes <= aLast; i += reduction_lanes)
+         {
+            for (std::size_t lane = 0; lane < reduction_lanes; ++lane)
+            {
+               step(sums[lane], corrections[lane], aLoad(i + lane));
+            }
+         }
+         for (std::size_t lane = 0; i < aLast; ++i, ++lane)
+         {
+            step(sums[lane], corrections[lane], aLoad(i));
+         }
+
+         compensated_sum<T> result;
+         for (std::size_t lane = 0; lane < reduction_lanes; ++lane)
+         {
+            result.add(sums[lane]);
+            result.correction += KAHAN ? -corrections[lane] : corrections[lane];
+         }
+         return result;
+      }
+
+      //! Sums aLoad(i) for i in [aFirst, aLast) with aSummation.
+      template<typename T, typename LOAD>
+      compensated_sum<T> sum_range(std::size_t aFirst, std::size_t aLast, LOAD& aLoad, summation aSummation) noexcept
+      {
+         if (!std::is_floating_point_v<T> || aSummation == summation::pairwise)
+         {
+            return { pairwise_sum<T>(aFirst, aLast, aLoad), T() };
+         }
+         return aSummation == summation::kahan ? compensated_lane_sum<true, T>(aFirst, aLast, aLoad)
+                                               : compensated_lane_sum<false, T>(aFirst, aLast, aLoad);
+      }
+
+      //! Returns aValue if it is smaller (or larger, if MAX) than aCurrent, and aCurrent otherwise.
+      template<bool MAX, typename T>
+      constexpr T select_extremum(T aCurrent, T aValue) noexcept
+      {
+         return (MAX ? aCurrent < aValue : aValue < aCurrent) ? aValue : aCurrent;
+      }
+
+      //! Returns the smaller (or larger, if MAX) of aLoad(i) for i in [aFirst, aLast), which must not be empty.
+      template<bool MAX, typename T, typename LOAD>
+      T extremum_range(std::size_t aFirst, std::size_t aLast, LOAD& aLoad) noexcept
+      {
+         const auto select = select_extremum<MAX, T>;
+         std::array<T, reduction_lanes> lanes;
+         lanes.fill(aLoad(aFirst));
+         std::size_t i = aFirst;
+         for (; i + reduction_lanes <= aLast; i += reduction_lanes)
+         {
+            for (std::size_t lane = 0; lane < reduction_lanes; ++lane)
+            {
+               lanes[lane] = select(lanes[lane], aLoad(i + lane));
+            }
+         }
+         for (; i < aLast; ++i)
+         {
+            lanes[0] = select(lanes[0], aLoad(i));
+         }
+         T result = lanes[0];
+         for (std::size_t lane = 1; lane < reduction_lanes; ++lane)
+         {
+            result = select(result, lanes[lane]);
+         }
+         return result;
+      }
+   }
+
+   //! Returns the sum of aValues, or zero if it is empty.
+   template<contiguous_quantity_range RANGE>
+   auto sum(const RANGE& aValues, summation aSummation = summation::pairwise) noexcept
+   {
+      using value_type = rgf::detail::range_value_t<RANGE>;
+      const auto values = rgf::detail::range_values(aValues);
+      auto load = [values](std::size_t aIndex) { return values[aIndex]; };
+      return quantity<rgf::detail::range_dimension_t<RANGE>, value_type>(std::in_place,
+         rgf::detail::sum_range<value_type>(0, values.size(), load, aSummation).value());
+   }
+
+   //! Returns the arithmetic mean of aValues, which must not be empty.
+   //! For integral value types, the mean is truncated like any other integer division.
+   template<contiguous_quantity_range RANGE>
+   auto mean(const RANGE& aValues, summation aSummation = summation::pairwise) noexcept
+   {
+      assert(aValues.size() > 0);
+      return rgf::sum(aValues, aSummation) / static_cast<rgf::detail::range_value_t<RANGE>>(aValues.size());
+   }
+
+   //! Returns the smallest element of aValues, which must not be empty.
+   //! As with std::min, NaN values are only returned if they are first.
+   template<contiguous_quantity_range RANGE>
+   auto min(const RANGE& aValues) noexcept
+   {
+      assert(aValues.size() > 0);
+      using value_type = rgf::detail::range_value_t<RANGE>;
+      const auto values = rgf::detail::range_values(aValues);
+      auto load = [values](std::size_t aIndex) { return values[aIndex]; };
+      return quantity<rgf::detail::range_dimension_t<RANGE>, value_type>(std::in_place,
+         rgf::detail::extremum_range<false, value_type>(0, values.size(), load));
+   }
+
+   //! Returns the largest element of aValues, which must not be empty.
+   //! As with std::max, NaN values are only returned if they are first.
+   template<contiguous_quantity_range RANGE>
+   auto max(const RANGE& aValues) noexcept
+   {
+      assert(aValues.size() > 0);
+      using value_type = rgf::detail::range_value_t<RANGE>;
+      const auto values = rgf::detail::range_values(aValues);
+      auto load = [values](std::size_t aIndex) { return values[aIndex]; };
+      return quantity<rgf::detail::range_dimension_t<RANGE>, value_type>(std::in_place,
+         rgf::detail::extremum_range<true, value_type>(0, values.size(), load));
+   }
+
+   //! Returns the sum of the element-wise products of aLeft and aRight, which must have the same size.
+   //! The result has the product of their dimensions, e.g. the dot product of lengths and forces is an energy.
+   //! Compensated summations compensate the additions only; each product is still rounded once.
+   template<contiguous_quantity_range LEFT_RANGE, contiguous_quantity_range RIGHT_RANGE>
+   auto dot(const LEFT_RANGE& aLeft, const RIGHT_RANGE& aRight, summation aSummation = summation::pairwise) noexcept
+   {
+      assert(aLeft.size() == aRight.size());
+      using value_type = std::common_type_t<rgf::detail::range_value_t<LEFT_RANGE>, rgf::detail::range_value_t<RIGHT_RANGE>>;
+      using dimension = dimension_product_t<rgf::detail::range_dimension_t<LEFT_RANGE>, rgf::detail::range_dimension_t<RIGHT_RANGE>>;
+      const auto left = rgf::detail::range_values(aLeft);
+      const auto right = rgf::detail::range_values(aRight);
+      auto load = [left, right](std::size_t aIndex) { return static_cast<value_type>(left[aIndex]) * static_cast<value_type>(right[aIndex]); };
+      return quantity<dimension, value_type>(std::in_place, rgf::detail::sum_range<value_type>(0, left.size(), load, aSummation).value());
+   }
+
+   //! Returns the sum of the squares of aValues, which has the square of their dimension, e.g. an area for lengths.
+   template<contiguous_quantity_range RANGE>
+   auto sum_of_squares(const RANGE& aValues, summation aSummation = summation::pairwise) noexcept
+   {
+      return rgf::dot(aValues, aValues, aSummation);
+   }
+}
@@ -0,0 +1,117 @@
+#pragma once
+
+#include "Dimension.hpp"
+#include "PackedDimension.hpp"
+
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+namespace rgf
+{
+   namespace detail
+   {
+      //! The 'value' member of dimension_base_names holds dimension_base_name_v for every base of BASE_TYPES_T, in order.
+      template<typename BASE_TYPES_T>
+      struct dimension_base_names;
+      template<template<int> typename... BASE_TYPES>
+      struct dimension_base_names<rgf::base_types_t<BASE_TYPES...>>
+      {
+         constexpr static std::array<std::string_view, sizeof...(BASE_TYPES)> value = { rgf::dimension_base_name_v<BASE_TYPES>... };
+      };
+   }
+
+   //! runtime_dimension<BASE_SYSTEM> is a dimension known only at runtime, over the bases of BASE_SYSTEM.
+   //! Exponents are packed into one integer in the same layout as packed_dimension_t, one signed 8-bit lane per base,
+   //!    so comparing two dimensions is a single integer compare, and multiplying or dividing them is a single SWAR add or subtract.
+   //! Exponents wrap around outside of [-128, 127].
+   //! E.g. auto speed = rgf::runtime_dimension<rgf::standard_system>::of<rgf::velocity_dimension>();
+   template<base_system BASE_SYSTEM>
+   class runtime_dimension
+   {
+   public:
+      using base_system_type = BASE_SYSTEM;
+
+      constexpr static std::size_t base_count = base_count_v<base_types_of_t<base_system_type>>;
+
+      //! When default-constructed, every exponent is zero.
+      constexpr runtime_dimension() noexcept = default;
+
+      //! Returns the runtime equivalent of DIM, which must have exactly the bases of BASE_SYSTEM, in the same order.
+      template<dimension_type DIM>
+      constexpr static runtime_dimension of() noexcept
+      {
+         return from_exponents(packed_dimension_type_t<DIM, base_system_type>::exponents);
+      }
+      //! Constructs the dimension with the given packed exponents, see rgf::pack_exponents.
+      constexpr static runtime_dimension from_exponents(packed_exponents aExponents) noexcept
+      {
+         runtime_dimension result;
+         result.mExponents = aExponents;
+         return result;
+      }
+
+      constexpr packed_exponents exponents() const noexcept
+      {
+         return mExponents;
+      }
+      //! Returns the exponent of the aIndex'th base.
+      constexpr int exponent(std::size_t aIndex) const noexcept
+      {
+         assert(aIndex < base_count);
+         return rgf::unpack_exponent(mExponents, aIndex);
+      }
+
+      //! True if every exponent is zero.
+      constexpr bool is_scalar() const noexcept
+      {
+         return mExponents == 0;
+      }
+
+      //! Returns the same fingerprint as dimension_id_v for the equivalent dimension_t.
+      //! Unlike comparisons, this hashes every base name, so it should be computed once per message rather than per value.
+      constexpr std::uint64_t id() const noexcept
+      {
+         constexpr auto& names = rgf::detail::dimension_base_names<base_types_of_t<base_system_type>>::value;
+         std::uint64_t hash = rgf::detail::fnv1a(std::string_view());
+         for (std::size_t i = 0; i < base_count; ++i)
+         {
+            hash = rgf::detail::hash_dimension_base(names[i], exponent(i), hash);
+         }
+         return hash;
+      }
+
+      //! Returns true if the dimension raised to aNum / aDen has all integral exponents within [-128, 127].
+      constexpr bool has_power(int aNum, int aDen = 1) const noexcept
+      {
+         return rgf::detail::is_valid_packed_power(mExponents, aNum, aDen);
+      }
+      //! Returns the dimension raised to aNum / aDen.
+      //! has_power(aNum, aDen) must be true.
+      constexpr runtime_dimension power(int aNum, int aDen = 1) const noexcept
+      {
+         assert(has_power(aNum, aDen));
+         return from_exponents(rgf::detail::scale_packed_exponents(mExponents, aNum, aDen));
+      }
+      constexpr runtime_dimension inverse() const noexcept
+      {
+         return from_exponents(rgf::detail::subtract_packed_exponents(0, mExponents));
+      }
+
+      constexpr friend runtime_dimension operator*(const runtime_dimension& aLeft, const runtime_dimension& aRight) noexcept
+      {
+         return from_exponents(rgf::detail::add_packed_exponents(aLeft.mExponents, aRight.mExponents));
+      }
+      constexpr friend runtime_dimension operator/(const runtime_dimension& aLeft, const runtime_dimension& aRight) noexcept
+      {
+         return from_exponents(rgf::detail::subtract_packed_exponents(aLeft.mExponents, aRight.mExponents));
+      }
+
+      constexpr friend bool operator==(const runtime_dimension& aLeft, const runtime_dimension& aRight) noexcept = default;
+
+   private:
+      packed_exponents mExponents = 0;
+   };
+}
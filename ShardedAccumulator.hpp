@@ -0,0 +1,118 @@
+#pragma once
+
+#include "AtomicQuantity.hpp"
+#include "Dimension.hpp"
+#include "Quantity.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <memory>
+#include <thread>
+
+namespace rgf
+{
+   //! Alignment in bytes of each shard of a sharded_accumulator.
+   //! 64 bytes is one cache line, so threads adding to different shards never write to the same line.
+   inline constexpr std::size_t shard_alignment = 64;
+
+   namespace detail
+   {
+      //! Returns the calling thread's index, counted from zero in the order threads first call it, and fixed afterwards.
+      //! Accumulators take it modulo their shard count, so shards are handed out round-robin: the first shard_count()
+      //!    threads to add get a shard each, and later threads share them. Threads that exit do not return their index,
+      //!    so a thread pool that is replaced over time can end up with several live threads on one shard.
+      inline std::size_t thread_shard_index() noexcept
+      {
+         static std::atomic<std::size_t> sNextIndex{ 0 };
+         thread_local const std::size_t sIndex = sNextIndex.fetch_add(1, std::memory_order_relaxed);
+         return sIndex;
+      }
+   }
+
+   //! sharded_accumulator<quantity<DIMENSION, VALUE_TYPE>> is a sum of quantities added from many threads,
+   //!    e.g. bytes transferred or energy used across the workers of a service.
+   //! Threads add to cache-line sized shards, handed out round-robin, so adding does not contend with other threads as a
+   //!    single atomic_quantity would. snapshot() sums the shards into a single quantity.
+   //! add() is a relaxed fetch_add on the thread's shard. For integral values it is wait-free; for floating point values it
+   //!    is a compare-exchange loop, which only retries when threads sharing a shard add at the same time.
+   //! A snapshot taken while other threads are adding includes some of their concurrent additions, but never part of one.
+   template<typename QUANTITY>
+   class sharded_accumulator;
+
+   template<dimension_type DIMENSION, arithmetic VALUE_TYPE>
+   class sharded_accumulator<quantity<DIMENSION, VALUE_TYPE>>
+   {
+   public:
+      using dimension = DIMENSION;
+      using value_type = VALUE_TYPE;
+
+      using quantity_type = quantity<dimension, value_type>;
+
+      //! Returns the default number of shards, which is the number of hardware threads rounded up to a power of two.
+      static std::size_t default_shard_count() noexcept
+      {
+         return std::bit_ceil(std::max<std::size_t>(std::thread::hardware_concurrency(), 1));
+      }
+
+      //! Constructs an accumulator with at least aShardCount shards, all zero.
+      //! The count is rounded up to a power of two.
+      explicit sharded_accumulator(std::size_t aShardCount = default_shard_count())
+         : mShardCount(std::bit_ceil(std::max<std::size_t>(aShardCount, 1)))
+         , mShards(std::make_unique<shard[]>(mShardCount))
+      {}
+
+      std::size_t shard_count() const noexcept
+      {
+         return mShardCount;
+      }
+
+      //! Adds aQuantity to the calling thread's shard.
+      void add(const quantity_type& aQuantity) noexcept
+      {
+         local_shard().fetch_add(aQuantity, std::memory_order_relaxed);
+      }
+      //! Subtracts aQuantity from the calling thread's shard.
+      void subtract(const quantity_type& aQuantity) noexcept
+      {
+         local_shard().fetch_sub(aQuantity, std::memory_order_relaxed);
+      }
+
+      //! Returns the sum of all shards.
+      quantity_type snapshot() const noexcept
+      {
+         quantity_type result;
+         for (std::size_t i = 0; i < mShardCount; ++i)
+         {
+            result += mShards[i].mValue.load(std::memory_order_relaxed);
+         }
+         return result;
+      }
+      //! Returns the sum of all shards and sets them to zero.
+      //! Each addition is counted by exactly one call, even when other threads are adding at the same time.
+      quantity_type snapshot_and_reset() noexcept
+      {
+         quantity_type result;
+         for (std::size_t i = 0; i < mShardCount; ++i)
+         {
+            result += mShards[i].mValue.exchange(quantity_type(), std::memory_order_relaxed);
+         }
+         return result;
+      }
+
+   private:
+      struct alignas(shard_alignment) shard
+      {
+         atomic_quantity<dimension, value_type> mValue;
+      };
+
+      atomic_quantity<dimension, value_type>& local_shard() noexcept
+      {
+         return mShards[rgf::detail::thread_shard_index() & (mShardCount - 1)].mValue;
+      }
+
+      std::size_t mShardCount;
+      std::unique_ptr<shard[]> mShards;
+   };
+}
@@ -0,0 +1,84 @@
+#pragma once
+
+#include "LinearUnit.hpp"
+#include "Quantity.hpp"
+
+#include <concepts>
+#include <cstddef>
+#include <experimental/simd>
+#include <span>
+
+namespace rgf
+{
+   //! SIMD vectors of arithmetic types may be used wherever rgf::arithmetic is required,
+   //!    so that e.g. rgf::quantity<rgf::velocity_dimension, std::experimental::native_simd<double>>
+   //!    holds one velocity per lane, and every operation on it processes all lanes at once.
+   //! Comparisons between such quantities return a simd_mask rather than an ordering.
+   template<typename T, typename ABI>
+   constexpr bool enable_arithmetic_v<std::experimental::simd<T, ABI>> = std::is_arithmetic_v<T>;
+
+   namespace detail
+   {
+      //! SIMD value types store the same factor as their element type, and broadcast it to every lane when converting,
+      //!    so a unit is as small as its scalar equivalent and each lane gives the same result as a scalar conversion.
+      //! Integral element types multiply by the numerator and divide by the denominator.
+      template<typename T, typename ABI>
+      class linear_factor<std::experimental::simd<T, ABI>>
+      {
+      public:
+         using value_type = std::experimental::simd<T, ABI>;
+         using factor_type = typename linear_factor<T>::factor_type;
+
+         constexpr linear_factor() noexcept = default;
+         constexpr linear_factor(factor_type aFactor) noexcept
+            : mFactor(aFactor)
+         {}
+
+         constexpr factor_type get() const noexcept
+         {
+            return mFactor;
+         }
+
+         value_type to_standard_value(const value_type& aValue) const noexcept
+         {
+            if constexpr (std::integral<T>)
+            {
+               return aValue * value_type(mFactor.num()) / value_type(mFactor.den());
+            }
+            else
+            {
+               return aValue * mFactor;
+            }
+         }
+         value_type from_standard_value(const value_type& aValue) const noexcept
+         {
+            if constexpr (std::integral<T>)
+            {
+               return aValue * value_type(mFactor.den()) / value_type(mFactor.num());
+            }
+            else
+            {
+               return aValue / mFactor;
+            }
+         }
+
+         void to_standard_values(std::span<const value_type> aValues, std::span<value_type> aResults) const noexcept
+         {
+            for (std::size_t i = 0; i < aValues.size(); ++i)
+            {
+               aResults[i] = to_standard_value(aValues[i]);
+            }
+         }
+         void from_standard_values(std::span<const value_type> aValues, std::span<value_type> aResults) const noexcept
+         {
+            for (std::size_t i = 0; i < aValues.size(); ++i)
+            {
+               aResults[i] = from_standard_value(aValues[i]);
+            }
+         }
+
+      private:
+         factor_type mFactor = factor_type(1);
+      };
+   }
+}
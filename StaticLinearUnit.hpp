@@ -0,0 +1,151 @@
+#pragma once
+
+#include "LinearUnit.hpp"
+#include "Quantity.hpp"
+
+#include <cstdint>
+#include <ratio>
+#include <type_traits>
+#include <utility>
+
+namespace rgf
+{
+   //! Boolean constant indicating if a type is a specialization of std::ratio.
+   template<typename>
+   constexpr bool is_ratio_v = false;
+   template<std::intmax_t NUM, std::intmax_t DEN>
+   constexpr bool is_ratio_v<std::ratio<NUM, DEN>> = true;
+
+   //! Concept version of is_ratio_v<T>
+   template<typename T>
+   concept ratio_type = is_ratio_v<T>;
+
+   //! static_linear_unit is a linear_unit whose conversion factor is an exact rational that is part of its type.
+   //! Every conversion compiles to a multiplication by a constant, even when the unit object itself is not constexpr
+   //!    at the point of use (e.g. it is a function parameter or a struct member).
+   //! Multiplying and dividing static_linear_units is done entirely at compile time.
+   //! A static_linear_unit is implicitly convertible to the linear_unit with the same factor.
+   template<rgf::dimension_type UNIT_DIMENSION, rgf::ratio_type UNIT_RATIO, rgf::arithmetic UNIT_VALUE_TYPE = double>
+   class static_linear_unit
+   {
+   public:
+      using dimension = UNIT_DIMENSION;
+      using ratio = typename UNIT_RATIO::type;
+      using value_type = UNIT_VALUE_TYPE;
+
+      using quantity_type = quantity<dimension, value_type>;
+      using linear_unit_type = linear_unit<dimension, value_type>;
+      using factor_type = typename linear_unit_type::factor_type;
+
+      constexpr explicit static_linear_unit() noexcept = default;
+
+      //! Returns the unit's conversion factor as the linear_unit_type would store it.
+      //! This is exact for integral value types, and rounded to factor_type otherwise.
+      constexpr static factor_type conversion_factor() noexcept
+      {
+         if constexpr (std::is_integral_v<value_type>)
+         {
+            return { static_cast<value_type>(ratio::num), static_cast<value_type>(ratio::den) };
+         }
+         else
+         {
+            return static_cast<factor_type>(ratio::num) / static_cast<factor_type>(ratio::den);
+         }
+      }
+
+      //! The call operator converts a value to a quantity with that value.
+      //! E.g. if kilometers is a unit, kilometers(5) would create a quantity with 5000 meters.
+      constexpr quantity_type operator()(value_type aValue) const noexcept
+      {
+         return { std::in_place, to_standard_value(aValue) };
+      }
+      constexpr static value_type to_standard_value(value_type aValue) noexcept
+      {
+         return scale<ratio>(aValue);
+      }
+      //! Converts from standard units into *this's unit.
+      constexpr static value_type from_standard_value(value_type aValue) noexcept
+      {
+         return scale<std::ratio_divide<std::ratio<1>, ratio>>(aValue);
+      }
+      //! Converts a quantity from standard units into *this's unit.
+      constexpr static value_type get(quantity_type aQuantity) noexcept
+      {
+         return from_standard_value(aQuantity.get_standard());
+      }
+
+      //! Creates a new static_linear_unit scaled up in size.
+      //! E.g. inline constexpr auto kilometers = meters.scaled_up<std::kilo>();
+      template<rgf::ratio_type FACTOR>
+      constexpr static auto scaled_up() noexcept
+      {
+         return static_linear_unit<dimension, std::ratio_multiply<ratio, FACTOR>, value_type>();
+      }
+      //! Creates a new static_linear_unit scaled down in size.
+      //! E.g. inline constexpr auto millimeters = meters.scaled_down<std::kilo>();
+      template<rgf::ratio_type FACTOR>
+      constexpr static auto scaled_down() noexcept
+      {
+         return static_linear_unit<dimension, std::ratio_divide<ratio, FACTOR>, value_type>();
+      }
+
+      //! Converts to the equivalent runtime linear_unit.
+      constexpr operator linear_unit_type() const noexcept
+      {
+         return { std::in_place, conversion_factor() };
+      }
+
+      //! Multiplies two static_linear_units together.
+      //! They must have the same value_type, but can have different dimensions.
+      //! E.g. torque.get(newtons * meters);
+      template<dimension_type RDIM, ratio_type RRATIO>
+      constexpr friend auto operator*(const static_linear_unit&, const static_linear_unit<RDIM, RRATIO, value_type>&) noexcept
+      {
+         return static_linear_unit<dimension_product_t<dimension, RDIM>, std::ratio_multiply<ratio, RRATIO>, value_type>();
+      }
+      //! Divides two static_linear_units.
+      //! They must have the same value_type, but can have different dimensions.
+      //! E.g. speed.get(meters / seconds);
+      template<dimension_type RDIM, ratio_type RRATIO>
+      constexpr friend auto operator/(const static_linear_unit&, const static_linear_unit<RDIM, RRATIO, value_type>&) noexcept
+      {
+         return static_linear_unit<dimension_quotient_t<dimension, RDIM>, std::ratio_divide<ratio, RRATIO>, value_type>();
+      }
+
+   private:
+      //! Multiplies aValue by FACTOR.
+      //! Floating point values are multiplied by a single constant.
+      //! Fixed-point values are multiplied and shifted by a constant fixed_scaler.
+      //! Integral values are multiplied by the numerator and divided by the denominator, either of which is skipped when it is one.
+      template<ratio_type FACTOR>
+      constexpr static value_type scale(value_type aValue) noexcept
+      {
+         if constexpr (FACTOR::num == 1 && FACTOR::den == 1)
+         {
+            return aValue;
+         }
+         else if constexpr (rgf::is_fixed_v<value_type>)
+         {
+            constexpr rgf::detail::fixed_scaler<value_type::bits> factor(static_cast<double>(FACTOR::num) / static_cast<double>(FACTOR::den));
+            return value_type::from_raw(factor(aValue.raw()));
+         }
+         else if constexpr (!std::is_integral_v<value_type>)
+         {
+            constexpr factor_type factor = static_cast<factor_type>(FACTOR::num) / static_cast<factor_type>(FACTOR::den);
+            return aValue * factor;
+         }
+         else if constexpr (FACTOR::den == 1)
+         {
+            return static_cast<value_type>(aValue * FACTOR::num);
+         }
+         else
+         {
+            return static_cast<value_type>(aValue * FACTOR::num / FACTOR::den);
+         }
+      }
+   };
+
+   //! Static units carry no data at all.
+   static_assert(std::is_empty_v<static_linear_unit<dimension_t<>, std::ratio<1>>>);
+   static_assert(std::is_trivially_copyable_v<static_linear_unit<dimension_t<>, std::ratio<1>>>);
+}
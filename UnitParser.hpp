@@ -0,0 +1,517 @@
+#pragma once
+
+#include "CommonUnits.hpp"
+#include "DynamicQuantity.hpp"
+#include "RuntimeDimension.hpp"
+
+#include <array>
+#include <charconv>
+#include <concepts>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
+
+namespace rgf
+{
+   //! A unit parsed from text: its factor to standard units, and its dimension over the standard bases.
+   struct parsed_unit
+   {
+      double factor = 1;
+      runtime_dimension<standard_system> dimension;
+   };
+
+   namespace detail
+   {
+      //! One spelling of a unit in the parser's table.
+      struct unit_table_row
+      {
+         std::string_view name;
+         double factor;
+         packed_exponents dimension;
+      };
+
+      template<typename UNIT>
+      constexpr unit_table_row make_unit_table_row(std::string_view aName, const UNIT& aUnit) noexcept
+      {
+         return { aName, static_cast<double>(aUnit.conversion_factor()),
+            runtime_dimension<standard_system>::of<typename UNIT::dimension>().exponents() };
+      }
+
+#define LARGE_SI_PREFIX_ROWS(NAME, SYMBOL)                                  \
+      make_unit_table_row("deca" #NAME, deca##NAME),                        \
+      make_unit_table_row("da" SYMBOL, deca##NAME),                         \
+      make_unit_table_row("hecto" #NAME, hecto##NAME),                      \
+      make_unit_table_row("h" SYMBOL, hecto##NAME),                         \
+      make_unit_table_row("kilo" #NAME, kilo##NAME),                        \
+      make_unit_table_row("k" SYMBOL, kilo##NAME),                          \
+      make_unit_table_row("mega" #NAME, mega##NAME),                        \
+      make_unit_table_row("M" SYMBOL, mega##NAME),                          \
+      make_unit_table_row("giga" #NAME, giga##NAME),                        \
+      make_unit_table_row("G" SYMBOL, giga##NAME)
+
+#define SMALL_SI_PREFIX_ROWS(NAME, SYMBOL)                                  \
+      make_unit_table_row("deci" #NAME, deci##NAME),                        \
+      make_unit_table_row("d" SYMBOL, deci##NAME),                          \
+      make_unit_table_row("centi" #NAME, centi##NAME),                      \
+      make_unit_table_row("c" SYMBOL, centi##NAME),                         \
+      make_unit_table_row("milli" #NAME, milli##NAME),                      \
+      make_unit_table_row("m" SYMBOL, milli##NAME),                         \
+      make_unit_table_row("micro" #NAME, micro##NAME),                      \
+      make_unit_table_row("u" SYMBOL, micro##NAME),                         \
+      make_unit_table_row("µ" SYMBOL, micro##NAME),                         \
+      make_unit_table_row("nano" #NAME, nano##NAME),                        \
+      make_unit_table_row("n" SYMBOL, nano##NAME)
+
+      //! Every unit in CommonUnits.hpp, by name and by symbol.
+      inline constexpr unit_table_row unit_table_rows[] = {
+         make_unit_table_row("ul", ul),
+
+         make_unit_table_row("meters", meters),
+         make_unit_table_row("m", meters),
+         LARGE_SI_PREFIX_ROWS(meters, "m"),
+         SMALL_SI_PREFIX_ROWS(meters, "m"),
+         make_unit_table_row("inches", inches),
+         make_unit_table_row("in", inches),
+         make_unit_table_row("feet", feet),
+         make_unit_table_row("ft", feet),
+         make_unit_table_row("yards", yards),
+         make_unit_table_row("yd", yards),
+         make_unit_table_row("miles", miles),
+         make_unit_table_row("mi", miles),
+
+         make_unit_table_row("seconds", seconds),
+         make_unit_table_row("s", seconds),
+         SMALL_SI_PREFIX_ROWS(seconds, "s"),
+         make_unit_table_row("minutes", minutes),
+         make_unit_table_row("min", minutes),
+         make_unit_table_row("hours", hours),
+         make_unit_table_row("h", hours),
+         make_unit_table_row("days", days),
+         make_unit_table_row("d", days),
+         make_unit_table_row("weeks", weeks),
+         make_unit_table_row("wk", weeks),
+         make_unit_table_row("years", years),
+         make_unit_table_row("yr", years),
+         make_unit_table_row("months", months),
+         make_unit_table_row("mo", months),
+
+         make_unit_table_row("grams", grams),
+         make_unit_table_row("g", grams),
+         LARGE_SI_PREFIX_ROWS(grams, "g"),
+         SMALL_SI_PREFIX_ROWS(grams, "g"),
+
+         make_unit_table_row("radians", radians),
+         make_unit_table_row("rad", radians),
+         make_unit_table_row("degrees", degrees),
+         make_unit_table_row("deg", degrees),
+
+         make_unit_table_row("newtons", newtons),
+         make_unit_table_row("N", newtons),
+
+         make_unit_table_row("kelvins", kelvins),
+         make_unit_table_row("K", kelvins),
+         make_unit_table_row("rankines", rankines),
+         make_unit_table_row("R", rankines),
+
+         make_unit_table_row("bytes", bytes),
+         make_unit_table_row("B", bytes),
+         LARGE_SI_PREFIX_ROWS(bytes, "B"),
+         make_unit_table_row("kibibytes", kibibytes),
+         make_unit_table_row("KiB", kibibytes),
+         make_unit_table_row("mebibytes", mebibytes),
+         make_unit_table_row("MiB", mebibytes),
+         make_unit_table_row("gibibytes", gibibytes),
+         make_unit_table_row("GiB", gibibytes),
+         make_unit_table_row("bits", bits),
+         make_unit_table_row("bit", bits),
+         LARGE_SI_PREFIX_ROWS(bits, "bit"),
+
+         make_unit_table_row("hertz", hertz),
+         make_unit_table_row("Hz", hertz),
+         LARGE_SI_PREFIX_ROWS(hertz, "Hz"),
+      };
+
+#undef LARGE_SI_PREFIX_ROWS
+#undef SMALL_SI_PREFIX_ROWS
+
+      //! unit_table is a perfect hash table over unit_table_rows, built at compile time.
+      //! The seed is searched for when the table is built, so that every name hashes to a different slot,
+      //!    and a lookup is one hash, one slot load and one string compare.
+      class unit_table
+      {
+      public:
+         constexpr static std::size_t row_count = std::size(unit_table_rows);
+         constexpr static int slot_bits = 11;
+         constexpr static std::size_t slot_count = std::size_t(1) << slot_bits;
+         static_assert(row_count < 255, "Slots store row indices in one byte.");
+
+         consteval unit_table() noexcept
+         {
+            for (mSeed = 0; !try_seed(); ++mSeed)
+            {}
+         }
+
+         //! Returns the row named aName, or nullptr if there is none.
+         constexpr const unit_table_row* find(std::string_view aName) const noexcept
+         {
+            const std::uint8_t slot = mSlots[hash(aName, mSeed)];
+            if (slot == 0 || unit_table_rows[slot - 1].name.size() != aName.size())
+            {
+               return nullptr;
+            }
+            // Names are a few characters long, so an inline loop beats calling memcmp.
+            const std::string_view name = unit_table_rows[slot - 1].name;
+            for (std::size_t i = 0; i < name.size(); ++i)
+            {
+               if (name[i] != aName[i])
+               {
+                  return nullptr;
+               }
+            }
+            return &unit_table_rows[slot - 1];
+         }
+
+      private:
+         constexpr static std::size_t hash(std::string_view aName, std::uint64_t aSeed) noexcept
+         {
+            std::uint64_t hash = 0xCBF2'9CE4'8422'2325 ^ aSeed;
+            for (char c : aName)
+            {
+               hash = (hash ^ static_cast<unsigned char>(c)) * 0x0000'0100'0000'01B3;
+            }
+            // FNV-1a leaves the last character in the middle bits, so mix it into the top bits used as the slot.
+            hash *= 0x9E37'79B9'7F4A'7C15;
+            return static_cast<std::size_t>(hash >> (64 - slot_bits));
+         }
+
+         constexpr bool try_seed() noexcept
+         {
+            mSlots = {};
+            for (std::size_t row = 0; row < row_count; ++row)
+            {
+               std::uint8_t& slot = mSlots[hash(unit_table_rows[row].name, mSeed)];
+               if (slot != 0)
+               {
+                  return false;
+               }
+               slot = static_cast<std::uint8_t>(row + 1);
+            }
+            return true;
+         }
+
+         std::uint64_t mSeed = 0;
+         std::array<std::uint8_t, slot_count> mSlots = {};
+      };
+
+      inline constexpr unit_table common_unit_table;
+
+      constexpr bool is_unit_name_character(char aCharacter) noexcept
+      {
+         // Bytes of multi-byte UTF-8 sequences are accepted for symbols such as the micro sign.
+         return (aCharacter >= 'a' && aCharacter <= 'z') || (aCharacter >= 'A' && aCharacter <= 'Z')
+            || static_cast<unsigned char>(aCharacter) >= 0x80;
+      }
+
+      //! Parses an optionally negative decimal integer like std::from_chars, which is not constexpr for integers until C++23.
+      //! Values beyond a million are rejected with std::errc::result_out_of_range.
+      constexpr std::from_chars_result parse_small_integer(const char* aFirst, const char* aLast, int& aValue) noexcept
+      {
+         const char* position = aFirst;
+         const bool negative = position != aLast && *position == '-';
+         position += negative;
+         const char* const digitsFirst = position;
+         int value = 0;
+         for (; position != aLast && *position >= '0' && *position <= '9'; ++position)
+         {
+            value = value * 10 + (*position - '0');
+            if (value > 1'000'000)
+            {
+               return { aFirst, std::errc::result_out_of_range };
+            }
+         }
+         if (position == digitsFirst)
+         {
+            return { aFirst, std::errc::invalid_argument };
+         }
+         aValue = negative ? -value : value;
+         return { position, std::errc() };
+      }
+
+      //! If aPosition starts the UTF-8 encoding of a superscript digit or minus, as written by rgf::dimension_symbol_v,
+      //!    returns the digit, or 10 for the minus, and sets aLength to the number of bytes. Otherwise returns -1.
+      constexpr int superscript(const char* aPosition, const char* aLast, int& aLength) noexcept
+      {
+         const auto byte = [aPosition](int aIndex) { return static_cast<unsigned char>(aPosition[aIndex]); };
+         if (aLast - aPosition >= 2 && byte(0) == 0xC2 && (byte(1) == 0xB2 || byte(1) == 0xB3 || byte(1) == 0xB9))
+         {
+            aLength = 2;
+            return byte(1) == 0xB9 ? 1 : byte(1) - 0xB0;
+         }
+         if (aLast - aPosition >= 3 && byte(0) == 0xE2 && byte(1) == 0x81 && (byte(2) == 0xB0 || (byte(2) >= 0xB4 && byte(2) <= 0xB9) || byte(2) == 0xBB))
+         {
+            aLength = 3;
+            return byte(2) == 0xBB ? 10 : byte(2) - 0xB0;
+         }
+         return -1;
+      }
+
+      //! Parses a superscript integer such as "⁻²" like parse_small_integer.
+      constexpr std::from_chars_result parse_superscript_integer(const char* aFirst, const char* aLast, int& aValue) noexcept
+      {
+         const char* position = aFirst;
+         int length = 0;
+         const bool negative = rgf::detail::superscript(position, aLast, length) == 10;
+         position += negative ? length : 0;
+         const char* const digitsFirst = position;
+         int value = 0;
+         for (int digit; (digit = rgf::detail::superscript(position, aLast, length)) >= 0 && digit < 10; position += length)
+         {
+            value = value * 10 + digit;
+            if (value > 1'000'000)
+            {
+               return { aFirst, std::errc::result_out_of_range };
+            }
+         }
+         if (position == digitsFirst)
+         {
+            return { aFirst, std::errc::invalid_argument };
+         }
+         aValue = negative ? -value : value;
+         return { position, std::errc() };
+      }
+
+      //! True if aPosition starts the UTF-8 encoding of '·', which separates terms like '*'.
+      constexpr bool is_middle_dot(const char* aPosition, const char* aLast) noexcept
+      {
+         return aLast - aPosition >= 2 && aPosition[0] == '\xC2' && aPosition[1] == '\xB7';
+      }
+   }
+
+   //! Parses a unit expression such as "km/h", "m/s^2", "kg*m*s^-2" or "N·m" from [aFirst, aLast), in the style of std::from_chars.
+   //! An expression is one or more unit names or symbols from CommonUnits.hpp, each optionally raised to an integer power
+   //!    with '^' or in superscript, separated by '*', '·' or '/'. Each '/' divides by the single term that follows it.
+   //! So the symbols written by rgf::dimension_symbol_v, such as "kg·m·s⁻²", are read back.
+   //! Temperatures are read in kelvins or rankines. Celsius and fahrenheit are offset from them, so they have no factor.
+   //! Parsing stops at the first character that cannot continue the expression, which is returned in ptr.
+   //! On failure, ec is std::errc::invalid_argument, ptr points at the offending term, and aUnit is unmodified.
+   //!    A term fails if it is unknown, or if it takes the expression's exponent of any base out of [-128, 127].
+   //! No memory is allocated.
+   constexpr std::from_chars_result parse_unit(const char* aFirst, const char* aLast, parsed_unit& aUnit) noexcept
+   {
+      parsed_unit result;
+      double denominator = 1;
+      const char* position = aFirst;
+      bool divide = false;
+      while (true)
+      {
+         const char* const termStart = position;
+         int superscriptLength = 0;
+         while (position != aLast && rgf::detail::is_unit_name_character(*position) && !rgf::detail::is_middle_dot(position, aLast)
+            && rgf::detail::superscript(position, aLast, superscriptLength) < 0)
+         {
+            ++position;
+         }
+         const rgf::detail::unit_table_row* row = rgf::detail::common_unit_table.find(std::string_view(termStart, position - termStart));
+         if (!row)
+         {
+            return { termStart, std::errc::invalid_argument };
+         }
+
+         int exponent = 1;
+         if (position != aLast && *position == '^')
+         {
+            const auto [end, ec] = rgf::detail::parse_small_integer(position + 1, aLast, exponent);
+            if (ec != std::errc() || exponent < -127 || exponent > 127)
+            {
+               return { termStart, std::errc::invalid_argument };
+            }
+            position = end;
+         }
+         else if (rgf::detail::superscript(position, aLast, superscriptLength) >= 0)
+         {
+            const auto [end, ec] = rgf::detail::parse_superscript_integer(position, aLast, exponent);
+            if (ec != std::errc() || exponent < -127 || exponent > 127)
+            {
+               return { termStart, std::errc::invalid_argument };
+            }
+            position = end;
+         }
+         // Exponents are small, so repeated SWAR adds are cheaper than scaling every lane of the packed dimension.
+         // Divisors are collected separately, so that there is at most one floating point division per expression.
+         const bool divideTerm = divide != (exponent < 0);
+         const int count = exponent < 0 ? -exponent : exponent;
+         const auto dimension = runtime_dimension<standard_system>::from_exponents(row->dimension);
+         // Packed exponents wrap around, so a term that would take any total exponent out of [-128, 127] is rejected.
+         for (std::size_t base = 0; base < runtime_dimension<standard_system>::base_count; ++base)
+         {
+            const int total = result.dimension.exponent(base) + (divideTerm ? -count : count) * dimension.exponent(base);
+            if (total < -128 || total > 127)
+            {
+               return { termStart, std::errc::invalid_argument };
+            }
+         }
+         for (int i = 0; i < count; ++i)
+         {
+            if (divideTerm)
+            {
+               denominator *= row->factor;
+               result.dimension = result.dimension / dimension;
+            }
+            else
+            {
+               result.factor *= row->factor;
+               result.dimension = result.dimension * dimension;
+            }
+         }
+
+         if (position != aLast && (*position == '*' || *position == '/'))
+         {
+            divide = *position == '/';
+            ++position;
+         }
+         else if (rgf::detail::is_middle_dot(position, aLast))
+         {
+            divide = false;
+            position += 2;
+         }
+         else
+         {
+            break;
+         }
+      }
+      if (denominator != 1)
+      {
+         result.factor /= denominator;
+      }
+      aUnit = result;
+      return { position, std::errc() };
+   }
+
+   namespace detail
+   {
+      //! The largest power of ten that T represents exactly, or 0 if parse_decimal has no fast path for T.
+      template<typename T>
+      constexpr int max_exact_power_of_ten = std::is_same_v<T, double> ? 22 : std::is_same_v<T, float> ? 10 : 0;
+
+      //! Parses a number like std::from_chars, with a fast path for short decimals such as "12.5" or "-3e2".
+      //! When the digits fit in T's mantissa and the power of ten is exact in T, the value is the digits multiplied or divided
+      //!    by that power, which rounds once and so is correctly rounded, see Clinger, "How to read floating point numbers accurately".
+      //! Anything else, including long, hexadecimal, infinite and NaN inputs, falls back to std::from_chars.
+      template<std::floating_point T>
+      std::from_chars_result parse_decimal(const char* aFirst, const char* aLast, T& aValue) noexcept
+      {
+         constexpr int maxPower = max_exact_power_of_ten<T>;
+         if constexpr (maxPower > 0)
+         {
+            constexpr T powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+               1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+            const char* position = aFirst;
+            const bool negative = position != aLast && *position == '-';
+            position += negative;
+
+            std::uint64_t digits = 0;
+            int digitCount = 0;
+            int power = 0;
+            for (; position != aLast && *position >= '0' && *position <= '9'; ++position, ++digitCount)
+            {
+               digits = digits * 10 + static_cast<unsigned>(*position - '0');
+            }
+            if (position != aLast && *position == '.')
+            {
+               for (++position; position != aLast && *position >= '0' && *position <= '9'; ++position, ++digitCount, --power)
+               {
+                  digits = digits * 10 + static_cast<unsigned>(*position - '0');
+               }
+            }
+
+            bool exact = digitCount > 0 && digitCount <= 19 && digits <= (std::uint64_t(1) << std::numeric_limits<T>::digits);
+            if (exact && position != aLast && (*position == 'e' || *position == 'E'))
+            {
+               const char* exponentFirst = position + 1;
+               const bool negativeExponent = exponentFirst != aLast && *exponentFirst == '-';
+               exponentFirst += exponentFirst != aLast && (*exponentFirst == '-' || *exponentFirst == '+');
+               unsigned exponent = 0;
+               const auto [end, ec] = std::from_chars(exponentFirst, aLast, exponent);
+               exact = ec == std::errc() && exponent <= static_cast<unsigned>(2 * maxPower);
+               power += negativeExponent ? -static_cast<int>(exponent) : static_cast<int>(exponent);
+               position = end;
+            }
+
+            if (exact && power >= -maxPower && power <= maxPower)
+            {
+               const T value = power < 0 ? static_cast<T>(digits) / powers[-power] : static_cast<T>(digits) * powers[power];
+               aValue = negative ? -value : value;
+               return { position, std::errc() };
+            }
+         }
+         return std::from_chars(aFirst, aLast, aValue);
+      }
+
+      //! Parses a number, optional spaces, and an optional unit expression, and sets aUnitFirst to the start of the unit.
+      //! A missing unit leaves aUnit as a scalar with a factor of one.
+      template<std::floating_point T>
+      std::from_chars_result parse_value_and_unit(const char* aFirst, const char* aLast, T& aValue, parsed_unit& aUnit,
+         const char*& aUnitFirst) noexcept
+      {
+         const auto number = rgf::detail::parse_decimal(aFirst, aLast, aValue);
+         if (number.ec != std::errc())
+         {
+            return number;
+         }
+         const char* position = number.ptr;
+         while (position != aLast && *position == ' ')
+         {
+            ++position;
+         }
+         aUnitFirst = position;
+         if (position == aLast || !rgf::detail::is_unit_name_character(*position))
+         {
+            aUnit = parsed_unit();
+            return { number.ptr, std::errc() };
+         }
+         return rgf::parse_unit(position, aLast, aUnit);
+      }
+   }
+
+   //! Parses a quantity such as "12.5 km/h" from [aFirst, aLast), in the style of std::from_chars.
+   //! The number is parsed by std::from_chars, and may be followed by spaces and a unit expression, see parse_unit.
+   //! A number without a unit is a scalar.
+   //! Overload 1 requires the unit to have dimension DIMENSION. If it does not, ec is std::errc::invalid_argument
+   //!    and ptr points at the start of the unit.
+   //! Overload 2 accepts any unit, and stores its dimension in aQuantity.
+   //! On failure, aQuantity is unmodified. No memory is allocated.
+   template<dimension_type DIMENSION, std::floating_point T>
+   std::from_chars_result parse_quantity(const char* aFirst, const char* aLast, quantity<DIMENSION, T>& aQuantity) noexcept
+   {
+      T value;
+      parsed_unit unit;
+      const char* unitFirst;
+      const auto result = rgf::detail::parse_value_and_unit(aFirst, aLast, value, unit, unitFirst);
+      if (result.ec != std::errc())
+      {
+         return result;
+      }
+      if (unit.dimension != runtime_dimension<standard_system>::of<DIMENSION>())
+      {
+         return { unitFirst, std::errc::invalid_argument };
+      }
+      aQuantity.set_standard_value(static_cast<T>(value * unit.factor));
+      return result;
+   }
+   template<std::floating_point T>
+   std::from_chars_result parse_quantity(const char* aFirst, const char* aLast, dynamic_quantity<standard_system, T>& aQuantity) noexcept
+   {
+      T value;
+      parsed_unit unit;
+      const char* unitFirst;
+      const auto result = rgf::detail::parse_value_and_unit(aFirst, aLast, value, unit, unitFirst);
+      if (result.ec == std::errc())
+      {
+         aQuantity = dynamic_quantity<standard_system, T>(static_cast<T>(value * unit.factor), unit.dimension);
+      }
+      return result;
+   }
+}